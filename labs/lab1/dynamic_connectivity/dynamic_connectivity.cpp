@@ -0,0 +1,185 @@
+/**
+ * Johannes Kung johku144
+ *
+ * Offline dynamic connectivity: answers connectivity queries on a graph where
+ * edges are both added and removed, using divide and conquer over time
+ * (a segment tree over the query timeline) and a Union-Find with rollback.
+ *
+ * Input: N Q followed by Q operations on the form "op a b" where op is
+ *  - '+': add the undirected edge a-b
+ *  - '-': remove the undirected edge a-b
+ *  - '?': query whether a and b are connected
+ *
+ * Time complexity: O(Q*log(Q)*log(N)), see solve()
+ * Memory consumption: O(N+Q*log(Q))
+ */
+#include <iostream>
+#include <ios>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "rollback_union_find.h"
+
+using namespace std;
+using Edge = pair<int, int>;
+
+/**
+ * A struct for neatly storing queries to the dynamic connectivity structure.
+ */
+struct Query {
+  char operation;
+  int operand1;
+  int operand2;
+
+  Query(char operation, int operand1, int operand2) {
+    this->operation = operation;
+    this->operand1 = operand1;
+    this->operand2 = operand2;
+  }
+};
+
+/**
+ * Segment tree over the time steps 0...Q-1 where every node stores the edges
+ * that are present during the whole time interval covered by the node, but not
+ * during the whole interval covered by its parent.
+ */
+struct TimeSegmentTree {
+  int size;
+  vector<vector<Edge>> edges;
+
+  TimeSegmentTree(int size) : size(size), edges(4 * max(size, 1)) {}
+
+  /**
+   * Adds the edge to the O(log(Q)) nodes covering the time interval [l, r)
+   */
+  void add(int l, int r, Edge e) {
+    add(1, 0, size, l, r, e);
+  }
+
+  void add(int node, int node_l, int node_r, int l, int r, Edge &e) {
+    if (r <= node_l || node_r <= l) {
+      return;
+    }
+    if (l <= node_l && node_r <= r) {
+      edges[node].push_back(e);
+      return;
+    }
+    int mid = (node_l + node_r) / 2;
+    add(2*node, node_l, mid, l, r, e);
+    add(2*node + 1, mid, node_r, l, r, e);
+  }
+};
+
+/**
+ * Traverses the segment tree depth first, joining the edges of a node when
+ * entering it and rolling them back when leaving it. At a leaf the Union-Find
+ * therefore contains exactly the edges present at that time step.
+ *
+ * Time complexity: O(Q*log(Q)*log(N)) as every edge is joined in O(log(Q))
+ * nodes and every join/find is O(log(N)) without path compression
+ */
+void answer_queries(
+    TimeSegmentTree &tree,
+    RollbackUnionSet &union_set,
+    vector<Query> &queries,
+    vector<string> &answers,
+    int node,
+    int node_l,
+    int node_r
+    ) {
+  int snapshot = union_set.snapshot();
+  for (Edge &e : tree.edges[node]) {
+    union_set.join(e.first, e.second);
+  }
+
+  if (node_r - node_l == 1) {
+    Query &q = queries[node_l];
+    if (q.operation == '?') {
+      answers[node_l] = union_set.same(q.operand1, q.operand2) ? "yes" : "no";
+    }
+  }
+  else {
+    int mid = (node_l + node_r) / 2;
+    answer_queries(tree, union_set, queries, answers, 2*node, node_l, mid);
+    answer_queries(tree, union_set, queries, answers, 2*node + 1, mid, node_r);
+  }
+
+  union_set.rollback(snapshot);
+}
+
+vector<string> solve(int N, vector<Query> &queries) {
+  int Q = queries.size();
+  TimeSegmentTree tree = TimeSegmentTree(Q);
+
+  // Find the interval of time steps during which each edge is present.
+  // An edge may be added several times (a multigraph), so the start times
+  // of every copy of an edge that is currently present are kept in a stack.
+  // O(Q*log(Q))
+  map<Edge, vector<int>> added_at;
+  for (int i = 0; i < Q; i++) {
+    Query &q = queries[i];
+    Edge e = {min(q.operand1, q.operand2), max(q.operand1, q.operand2)};
+    if (q.operation == '+') {
+      added_at[e].push_back(i);
+    }
+    else if (q.operation == '-') {
+      auto it = added_at.find(e);
+      // Removing an edge that is not present does nothing
+      if (it != added_at.end() && !it->second.empty()) {
+        tree.add(it->second.back(), i, e);
+        it->second.pop_back();
+      }
+    }
+  }
+
+  // Edges never removed are present until the end
+  for (auto &entry : added_at) {
+    for (int start : entry.second) {
+      tree.add(start, Q, entry.first);
+    }
+  }
+
+  vector<string> answers = vector<string>(Q);
+  if (Q > 0) {
+    RollbackUnionSet union_set = RollbackUnionSet(N);
+    answer_queries(tree, union_set, queries, answers, 1, 0, Q);
+  }
+
+  // Only the '?' operations produce an answer
+  vector<string> result;
+  for (int i = 0; i < Q; i++) {
+    if (queries[i].operation == '?') {
+      result.push_back(answers[i]);
+    }
+  }
+  return result;
+}
+
+int main() {
+  ios::sync_with_stdio(false);
+  cin.tie(nullptr);
+  cout.tie(nullptr);
+
+  int N, Q, a, b;
+  char op;
+  while (true) {
+    cin >> N >> Q;
+    if (cin.eof()) {
+      break;
+    }
+
+    vector<Query> queries;
+    while (Q > 0) {
+      cin >> op >> a >> b;
+      queries.push_back(Query(op, a, b));
+      Q--;
+    }
+
+    vector<string> answers = solve(N, queries);
+    for (string &ans : answers) {
+      cout << ans << "\n";
+    }
+  }
+  cout.flush();
+}
@@ -0,0 +1,98 @@
+/**
+ * Johannes Kung johku144
+ *
+ * Disjoint Set Union (DSU) with rollback, a.k.a. undoable Union-Find.
+ *
+ * Unlike the UnionSet in lab1/task4 this structure does not use path
+ * compression, as that would modify the parent of many elements in a single
+ * find and make undoing a join expensive. Union by size alone keeps the trees
+ * at depth O(log(n)).
+ *
+ * Every join() pushes the change it made onto a history stack, which
+ * rollback() pops to restore the structure to an earlier state.
+ *
+ * Time complexities:
+ * - find_representative(): O(log(n)) due to union by size
+ * - join() and same(): O(log(n)) as they rely on find_representative()
+ * - snapshot(): O(1)
+ * - rollback(): O(1) per undone join
+ */
+#pragma once
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+struct RollbackUnionSet {
+  vector<int> parent;
+  vector<int> size;
+
+  // The joins made so far, stored as (new child, new representative) pairs.
+  // A join where both elements were already in the same set is not stored
+  vector<pair<int, int>> history;
+
+  // Number of disjoint sets
+  int components;
+
+  RollbackUnionSet(int n) : parent(n), size(n, 1), components(n) {
+    // O(N)
+    // Initialise every element to belong to a set with itself only
+    for (int i = 0; i < n; i++) {
+      parent[i] = i;
+    }
+  }
+
+  int find_representative(int e) {
+    // Follow the chain of parents without compressing it, so that every
+    // join only ever changes a single parent pointer
+    while (parent[e] != e) {
+      e = parent[e];
+    }
+    return e;
+  }
+
+  bool join(int a, int b) {
+    a = find_representative(a);
+    b = find_representative(b);
+    if (a == b) {
+      return false;
+    }
+
+    // Union by size: hang the smaller tree below the larger one so that the
+    // depth of any tree is at most log(n)
+    if (size[a] > size[b]) {
+      swap(a, b);
+    }
+    parent[a] = b;
+    size[b] += size[a];
+    components--;
+    history.push_back({a, b});
+    return true;
+  }
+
+  bool same(int a, int b) {
+    return find_representative(a) == find_representative(b);
+  }
+
+  /**
+   * Returns a handle to the current state which may be passed to rollback()
+   */
+  int snapshot() {
+    return history.size();
+  }
+
+  /**
+   * Undoes all joins made since the given snapshot was taken, in reverse order
+   */
+  void rollback(int snapshot) {
+    while (history.size() > snapshot) {
+      int child = history.back().first;
+      int root = history.back().second;
+      history.pop_back();
+
+      parent[child] = child;
+      size[root] -= size[child];
+      components++;
+    }
+  }
+};
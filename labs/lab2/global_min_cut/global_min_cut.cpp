@@ -0,0 +1,317 @@
+/**
+ * Johannes Kung johku144
+ *
+ * Global minimum cut of an undirected weighted graph, i.e. the lightest set
+ * of edges whose removal disconnects the graph, without a fixed source or
+ * sink. Uses the Stoer-Wagner algorithm, or alternatively the randomised
+ * Karger-Stein algorithm.
+ *
+ * Input: N M followed by M undirected edges "u v w"
+ * Output: the cut value, then the number of nodes on one side of the cut
+ *         followed by those nodes
+ *
+ * Usage: global_min_cut [--karger-stein [runs]] < input
+ *
+ * Time complexity:
+ *  - Stoer-Wagner: O(|V|*|E|*log(|V|)), see stoer_wagner()
+ *  - Karger-Stein: O(|V|^2*log^3(|V|)), see karger_stein()
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <ios>
+#include <queue>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "union_find.cpp"
+
+using namespace std;
+using i64 = int64_t;
+using WeightedEdge = tuple<int, int, i64>;
+
+// A cut is represented by its value and the nodes on one side of it
+using Cut = pair<i64, vector<int>>;
+
+/**
+ * Stoer-Wagner algorithm. Works in n-1 phases, each of which:
+ *  1. Orders the (merged) nodes by maximum adjacency: starting from any node,
+ *     repeatedly add the node most tightly connected to the nodes added so far.
+ *  2. The weight connecting the last node to all others is a min cut between
+ *     the last two nodes s and t (the "cut of the phase").
+ *  3. Merges s and t. Any cut separating them has been considered, and the
+ *     cuts that do not separate them are still present in the merged graph.
+ *
+ * The maximum adjacency ordering uses a max-heap of (connection, node) pairs
+ * with lazy deletion. Merged nodes keep the concatenated adjacency lists of
+ * the original nodes they contain, so every phase looks at every edge once.
+ *
+ * Time complexity: O(|V|*|E|*log(|V|)), n-1 phases of O(|E|*log(|V|))
+ */
+Cut stoer_wagner(int n, vector<WeightedEdge> &edges) {
+  if (n < 2) {
+    return {0, {}};
+  }
+
+  // Adjacency lists of the original nodes: (neighbour, weight)
+  vector<vector<pair<int, i64>>> adj = vector<vector<pair<int, i64>>>(n);
+  for (WeightedEdge &e : edges) {
+    if (get<0>(e) != get<1>(e)) {
+      adj[get<0>(e)].push_back({get<1>(e), get<2>(e)});
+      adj[get<1>(e)].push_back({get<0>(e), get<2>(e)});
+    }
+  }
+
+  // The merged node owning every original node, and the original nodes
+  // merged into every node
+  vector<int> owner = vector<int>(n);
+  vector<vector<int>> members = vector<vector<int>>(n);
+  vector<int> alive;
+  for (int v = 0; v < n; v++) {
+    owner[v] = v;
+    members[v] = {v};
+    alive.push_back(v);
+  }
+
+  Cut best = {-1, {}};
+  vector<i64> connection = vector<i64>(n);
+  vector<bool> added = vector<bool>(n);
+  while (alive.size() > 1) {
+    for (int v : alive) {
+      connection[v] = 0;
+      added[v] = false;
+    }
+    priority_queue<pair<i64, int>> to_add;
+    for (int v : alive) {
+      to_add.push({0, v});
+    }
+
+    int prev = -1;
+    int last = -1;
+    for (int i = 0; i < alive.size(); i++) {
+      int u;
+      while (true) {
+        u = to_add.top().second;
+        i64 c = to_add.top().first;
+        to_add.pop();
+        if (!added[u] && c == connection[u]) {
+          break;
+        }
+      }
+      added[u] = true;
+      prev = last;
+      last = u;
+
+      for (int m : members[u]) {
+        for (pair<int, i64> &neighbour : adj[m]) {
+          int w = owner[neighbour.first];
+          if (!added[w]) {
+            connection[w] += neighbour.second;
+            to_add.push({connection[w], w});
+          }
+        }
+      }
+    }
+
+    if (best.first == -1 || connection[last] < best.first) {
+      best = {connection[last], members[last]};
+    }
+
+    // Merge last into prev
+    for (int m : members[last]) {
+      owner[m] = prev;
+      members[prev].push_back(m);
+    }
+    members[last].clear();
+    alive.erase(find(alive.begin(), alive.end(), last));
+  }
+
+  sort(best.second.begin(), best.second.end());
+  return best;
+}
+
+/**
+ * A graph in the recursion of Karger-Stein, with nodes 0, ..., n-1.
+ */
+struct ContractedGraph {
+  int n;
+  vector<WeightedEdge> edges;
+
+  // The node of the contracted graph that every node of the graph it was
+  // contracted from was merged into
+  vector<int> merged_into;
+};
+
+/**
+ * Contracts random edges of the graph until only "target" nodes remain. An
+ * edge is picked with probability proportional to its weight by ordering the
+ * edges on exponentially distributed keys with rate equal to the weight and
+ * contracting them in that order, like Kruskal's algorithm, using Union-Find.
+ * Parallel edges that arise are merged.
+ *
+ * Time complexity: O(|E|*log(|E|))
+ */
+ContractedGraph contract(ContractedGraph &g, int target, mt19937_64 &rng) {
+  vector<pair<double, int>> order;
+  for (int i = 0; i < g.edges.size(); i++) {
+    double key = exponential_distribution<double>(get<2>(g.edges[i]))(rng);
+    order.push_back({key, i});
+  }
+  sort(order.begin(), order.end());
+
+  UnionSet union_set = UnionSet(g.n);
+  int nodes = g.n;
+  for (int i = 0; i < order.size() && nodes > target; i++) {
+    WeightedEdge &e = g.edges[order[i].second];
+    if (!union_set.same(get<0>(e), get<1>(e))) {
+      union_set.join(get<0>(e), get<1>(e));
+      nodes--;
+    }
+  }
+
+  // Renumber the remaining nodes and merge parallel edges
+  ContractedGraph result;
+  result.n = 0;
+  result.merged_into = vector<int>(g.n);
+  vector<int> index = vector<int>(g.n, -1);
+  for (int v = 0; v < g.n; v++) {
+    int r = union_set.find_representative(v);
+    if (index[r] == -1) {
+      index[r] = result.n++;
+    }
+    result.merged_into[v] = index[r];
+  }
+
+  vector<WeightedEdge> edges;
+  for (WeightedEdge &e : g.edges) {
+    int a = result.merged_into[get<0>(e)];
+    int b = result.merged_into[get<1>(e)];
+    if (a != b) {
+      edges.push_back({min(a, b), max(a, b), get<2>(e)});
+    }
+  }
+  sort(edges.begin(), edges.end());
+  for (WeightedEdge &e : edges) {
+    if (!result.edges.empty()
+        && get<0>(result.edges.back()) == get<0>(e)
+        && get<1>(result.edges.back()) == get<1>(e)) {
+      get<2>(result.edges.back()) += get<2>(e);
+    }
+    else {
+      result.edges.push_back(e);
+    }
+  }
+  return result;
+}
+
+/**
+ * One run of the recursive Karger-Stein algorithm. The graph is contracted to
+ * about n/sqrt(2) nodes twice independently and the best cut of the two
+ * recursive calls is returned, with its side translated back to the nodes of
+ * this graph. Small graphs are solved exactly with Stoer-Wagner. A run finds
+ * a min cut with probability Omega(1/log(n)).
+ *
+ * Time complexity: O(|V|^2*log(|V|))
+ */
+Cut karger_stein_run(ContractedGraph &g, mt19937_64 &rng) {
+  if (g.n <= 6) {
+    return stoer_wagner(g.n, g.edges);
+  }
+  if (g.edges.empty()) {
+    // The graph is disconnected, so any single node is separated from the
+    // rest by an empty cut
+    return {0, {0}};
+  }
+
+  int target = ceil(1 + g.n / sqrt(2));
+  Cut best = {-1, {}};
+  for (int i = 0; i < 2; i++) {
+    ContractedGraph contracted = contract(g, target, rng);
+    Cut cut = karger_stein_run(contracted, rng);
+    if (best.first == -1 || cut.first < best.first) {
+      vector<bool> on_side = vector<bool>(contracted.n, false);
+      for (int v : cut.second) {
+        on_side[v] = true;
+      }
+      best.first = cut.first;
+      best.second.clear();
+      for (int v = 0; v < g.n; v++) {
+        if (on_side[contracted.merged_into[v]]) {
+          best.second.push_back(v);
+        }
+      }
+    }
+  }
+  return best;
+}
+
+/**
+ * Karger-Stein randomised global min cut. Repeating the recursive contraction
+ * log^2(n) times finds a min cut with high probability, which is the default
+ * if the number of runs is not given. Every run is O(|V|^2*log(|V|))
+ * regardless of the number of edges, so fewer runs may be needed on large
+ * graphs at the cost of a lower success probability.
+ *
+ * Time complexity: O(|V|^2*log^3(|V|)) with the default number of runs
+ */
+Cut karger_stein(int n, vector<WeightedEdge> &edges, int runs = -1, int seed = 95) {
+  if (n < 2) {
+    return {0, {}};
+  }
+  ContractedGraph g;
+  g.n = n;
+  for (WeightedEdge &e : edges) {
+    // Edges of weight 0 never cross a min cut by being contracted
+    if (get<0>(e) != get<1>(e) && get<2>(e) > 0) {
+      g.edges.push_back(e);
+    }
+  }
+
+  mt19937_64 rng(seed);
+  if (runs < 1) {
+    runs = max(1.0, ceil(log2(n) * log2(n)));
+  }
+  Cut best = {-1, {}};
+  for (int i = 0; i < runs; i++) {
+    Cut cut = karger_stein_run(g, rng);
+    if (best.first == -1 || cut.first < best.first) {
+      best = cut;
+    }
+  }
+  return best;
+}
+
+int main(int argc, char *argv[]) {
+  ios::sync_with_stdio(false);
+  cin.tie(nullptr);
+  cout.tie(nullptr);
+
+  bool randomised = argc > 1 && strcmp(argv[1], "--karger-stein") == 0;
+  int runs = argc > 2 ? atoi(argv[2]) : -1;
+
+  int nodes, edges, u, v;
+  i64 w;
+  while (true) {
+    cin >> nodes >> edges;
+    if (cin.eof()) {
+      break;
+    }
+
+    vector<WeightedEdge> edge_list;
+    for (int e = 0; e < edges; e++) {
+      cin >> u >> v >> w;
+      edge_list.push_back({u, v, w});
+    }
+
+    Cut cut = randomised ? karger_stein(nodes, edge_list, runs) : stoer_wagner(nodes, edge_list);
+    cout << cut.first << "\n" << cut.second.size();
+    for (int x : cut.second) {
+      cout << " " << x;
+    }
+    cout << "\n";
+  }
+  cout.flush();
+}
@@ -0,0 +1,290 @@
+/**
+ * Johannes Kung johku144
+ *
+ * Gomory-Hu tree of an undirected network using Gusfield's algorithm, for
+ * answering min cut queries between all pairs of nodes.
+ *
+ * The tree has the same nodes as the network and the property that the min
+ * cut between any two nodes u and v equals the lightest edge on the path
+ * between them in the tree. Removing that edge splits the tree into the two
+ * sides of a min u-v cut in the network.
+ *
+ * Input: N M followed by M undirected edges "u v c", then Q queries "u v".
+ *
+ * Usage: gomory_hu [threads] < input
+ *
+ * Time complexity:
+ *  - Construction: n-1 max flow computations, i.e. O(|V|^3*|E|) with Dinic,
+ *    see gomory_hu()
+ *  - Queries: O(|V|), see min_cut() and cut_side()
+ * Memory consumption: O(threads*(|V|+|E|))
+ */
+#include <condition_variable>
+#include <cstdlib>
+#include <iostream>
+#include <ios>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "flow_network.h"
+#include "dinic.h"
+
+using namespace std;
+
+struct GomoryHuTree {
+  int n;
+
+  // The tree is rooted in node 0. Node u is connected to parent[u] with an
+  // edge of the given weight
+  vector<int> parent;
+  vector<i64> weight;
+  vector<int> depth;
+  vector<vector<int>> children;
+
+  /**
+   * Calculates the depth and children of every node from the parents.
+   *
+   * Time complexity: O(|V|)
+   */
+  void build_children() {
+    depth = vector<int>(n, 0);
+    children = vector<vector<int>>(n);
+    if (n == 0) {
+      return;
+    }
+    for (int u = 1; u < n; u++) {
+      children[parent[u]].push_back(u);
+    }
+    vector<int> stack = {0};
+    while (!stack.empty()) {
+      int u = stack.back();
+      stack.pop_back();
+      for (int c : children[u]) {
+        depth[c] = depth[u] + 1;
+        stack.push_back(c);
+      }
+    }
+  }
+
+  /**
+   * Returns the node x such that the edge from x to its parent is the
+   * lightest edge on the path between u and v.
+   *
+   * Time complexity: O(|V|) by walking up from the deeper node
+   */
+  int lightest_edge(int u, int v) {
+    int lightest = -1;
+    while (u != v) {
+      if (depth[u] < depth[v]) {
+        swap(u, v);
+      }
+      if (lightest == -1 || weight[u] < weight[lightest]) {
+        lightest = u;
+      }
+      u = parent[u];
+    }
+    return lightest;
+  }
+
+  /**
+   * Returns the value of a min cut between u and v.
+   *
+   * Time complexity: O(|V|)
+   */
+  i64 min_cut(int u, int v) {
+    if (u == v) {
+      return 0;
+    }
+    return weight[lightest_edge(u, v)];
+  }
+
+  /**
+   * Returns the nodes on the side of u of a min cut between u and v, which
+   * is the component of u when the lightest edge on the path is removed.
+   *
+   * Time complexity: O(|V|)
+   */
+  vector<int> cut_side(int u, int v) {
+    vector<bool> in_subtree = vector<bool>(n, false);
+    if (u != v) {
+      int x = lightest_edge(u, v);
+      vector<int> stack = {x};
+      in_subtree[x] = true;
+      while (!stack.empty()) {
+        int w = stack.back();
+        stack.pop_back();
+        for (int c : children[w]) {
+          in_subtree[c] = true;
+          stack.push_back(c);
+        }
+      }
+    }
+
+    vector<int> side;
+    for (int w = 0; w < n; w++) {
+      if (w == u || (u != v && in_subtree[w] == in_subtree[u])) {
+        side.push_back(w);
+      }
+    }
+    return side;
+  }
+};
+
+/**
+ * Computes a min s-t cut from scratch in the given network.
+ *
+ * Output: the cut value and whether every node is on the side of s, i.e.
+ *         reachable from s in the residual graph of a max flow
+ *
+ * Time complexity: O(|V|^2*|E|) for Dinic's algorithm
+ */
+pair<i64, vector<bool>> s_t_cut(FlowNetwork &network, int s, int t) {
+  network.reset();
+  i64 flow = dinic(network, s, t);
+
+  vector<bool> reached = vector<bool>(network.nodes, false);
+  reached[s] = true;
+  vector<int> stack = {s};
+  while (!stack.empty()) {
+    int u = stack.back();
+    stack.pop_back();
+    for (int e = network.first_edge[u]; e < network.first_edge[u + 1]; e++) {
+      int v = network.head[e];
+      if (!reached[v] && network.residual[e] > 0) {
+        reached[v] = true;
+        stack.push_back(v);
+      }
+    }
+  }
+  return {flow, reached};
+}
+
+/**
+ * Builds the Gomory-Hu tree of an undirected network with Gusfield's
+ * algorithm, which needs no graph contractions:
+ *
+ *  for every node s = 1, ..., n-1 with t = parent[s]:
+ *    find a min s-t cut (X, V-X) with s in X
+ *    every node in X with parent t gets parent s
+ *    if parent[t] is in X, s takes the place of t in the tree
+ *
+ * Iteration s only depends on the earlier ones through parent[s], so the
+ * cuts are computed speculatively by several threads, each with its own copy
+ * of the residual graph. The results are applied in order of s, and a cut
+ * is recomputed if parent[s] changed after it was computed.
+ *
+ * Time complexity: O(|V|) max flow computations, O(|V|^3*|E|) with Dinic
+ */
+GomoryHuTree gomory_hu(int n, vector<tuple<int, int, i64>> &edges, int threads) {
+  GomoryHuTree tree;
+  tree.n = n;
+  tree.parent = vector<int>(n, 0);
+  tree.weight = vector<i64>(n, 0);
+
+  // Every undirected edge is two directed edges with the same capacity
+  vector<tuple<int, int, i64>> directed_edges;
+  for (auto &e : edges) {
+    directed_edges.push_back({get<0>(e), get<1>(e), get<2>(e)});
+    directed_edges.push_back({get<1>(e), get<0>(e), get<2>(e)});
+  }
+  FlowNetwork network = FlowNetwork(n, directed_edges);
+
+  mutex m;
+  condition_variable turn_changed;
+  int next_to_claim = 1;
+  int next_to_apply = 1;
+
+  auto worker = [&]() {
+    FlowNetwork local = network;
+    while (true) {
+      int s, t;
+      {
+        lock_guard<mutex> lock(m);
+        s = next_to_claim++;
+        if (s >= n) {
+          return;
+        }
+        t = tree.parent[s];
+      }
+      pair<i64, vector<bool>> cut = s_t_cut(local, s, t);
+
+      unique_lock<mutex> lock(m);
+      turn_changed.wait(lock, [&] { return next_to_apply == s; });
+      if (tree.parent[s] != t) {
+        // The speculation failed: an earlier iteration moved s. No other
+        // thread may apply its result before this one, so the parents
+        // cannot change while the cut is recomputed
+        t = tree.parent[s];
+        lock.unlock();
+        cut = s_t_cut(local, s, t);
+        lock.lock();
+      }
+
+      i64 value = cut.first;
+      vector<bool> &on_s_side = cut.second;
+      tree.weight[s] = value;
+      for (int i = 0; i < n; i++) {
+        if (i != s && on_s_side[i] && tree.parent[i] == t) {
+          tree.parent[i] = s;
+        }
+      }
+      if (on_s_side[tree.parent[t]]) {
+        tree.parent[s] = tree.parent[t];
+        tree.parent[t] = s;
+        tree.weight[s] = tree.weight[t];
+        tree.weight[t] = value;
+      }
+      next_to_apply++;
+      turn_changed.notify_all();
+    }
+  };
+
+  vector<thread> workers;
+  for (int i = 1; i < threads; i++) {
+    workers.push_back(thread(worker));
+  }
+  worker();
+  for (thread &w : workers) {
+    w.join();
+  }
+
+  tree.build_children();
+  return tree;
+}
+
+int main(int argc, char *argv[]) {
+  ios::sync_with_stdio(false);
+  cin.tie(nullptr);
+  cout.tie(nullptr);
+
+  int threads = 1;
+  if (argc > 1) {
+    threads = max(1, atoi(argv[1]));
+  }
+
+  int nodes, edges, queries, u, v;
+  i64 c;
+  while (true) {
+    cin >> nodes >> edges;
+    if (cin.eof()) {
+      break;
+    }
+
+    vector<tuple<int, int, i64>> edge_list;
+    for (int e = 0; e < edges; e++) {
+      cin >> u >> v >> c;
+      edge_list.push_back({u, v, c});
+    }
+    GomoryHuTree tree = gomory_hu(nodes, edge_list, threads);
+
+    cin >> queries;
+    for (int q = 0; q < queries; q++) {
+      cin >> u >> v;
+      cout << tree.min_cut(u, v) << "\n";
+    }
+  }
+  cout.flush();
+}
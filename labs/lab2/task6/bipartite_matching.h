@@ -0,0 +1,253 @@
+/**
+ * Johannes Kung johku144
+ *
+ * Maximum flow of unit capacity bipartite networks using the Hopcroft-Karp
+ * maximum matching algorithm on the same CSR residual graph as the general
+ * solvers.
+ *
+ * A network is a unit capacity bipartite network if every edge with capacity
+ * > 0 is one of
+ *  - s->u with capacity 1, at most one per node u (u is a left node)
+ *  - v->t with capacity 1, at most one per node v (v is a right node)
+ *  - u->v from a left node to a right node, with any capacity
+ * and no node is both a left and a right node. A max flow of such a network
+ * is a maximum matching between the left and right nodes.
+ *
+ * Time complexity: O(|E|*sqrt(|V|)) (see hopcroft_karp())
+ * Memory consumption: O(|V|) on top of the residual graph
+ */
+#pragma once
+#include <vector>
+#include "flow_network.h"
+
+using namespace std;
+
+struct HopcroftKarp {
+  FlowNetwork &network;
+  int n;
+  int s;
+  int t;
+
+  // The residual edge s->u of every left node u and v->t of every right
+  // node v, -1 for other nodes
+  vector<int> source_edge;
+  vector<int> sink_edge;
+
+  // The residual edge of the matching of every left node, and the left node
+  // matched to every right node, -1 if unmatched
+  vector<int> match_edge;
+  vector<int> match_left;
+
+  // BFS level of every left node, current-arc pointers and the BFS queue,
+  // which is reused as the DFS stack
+  vector<int> level;
+  // The level of the left nodes that end the shortest augmenting paths
+  int last_level = -1;
+  vector<int> current_arc;
+  vector<int> queue;
+
+  HopcroftKarp(FlowNetwork &network, int s, int t)
+    : network(network),
+      n(network.nodes),
+      s(s),
+      t(t),
+      source_edge(n, -1),
+      sink_edge(n, -1),
+      match_edge(n, -1),
+      match_left(n, -1),
+      level(n),
+      current_arc(n) {}
+
+  /**
+   * Checks whether the network is a unit capacity bipartite network with
+   * source s and sink t and finds the left and right nodes.
+   *
+   * Time complexity: O(|V|+|E|)
+   */
+  bool is_unit_bipartite() {
+    if (s == t) {
+      return false;
+    }
+    for (int e : network.edge_index) {
+      int u = network.tail(e);
+      int v = network.head[e];
+      if (network.capacity[e] == 0) {
+        continue;
+      }
+      if (u == s) {
+        if (v == s || v == t || network.capacity[e] != 1 || source_edge[v] != -1) {
+          return false;
+        }
+        source_edge[v] = e;
+      }
+      else if (v == t) {
+        if (u == t || network.capacity[e] != 1 || sink_edge[u] != -1) {
+          return false;
+        }
+        sink_edge[u] = e;
+      }
+    }
+    for (int u = 0; u < n; u++) {
+      if (source_edge[u] != -1 && sink_edge[u] != -1) {
+        return false;
+      }
+    }
+    for (int e : network.edge_index) {
+      int u = network.tail(e);
+      int v = network.head[e];
+      if (network.capacity[e] == 0 || u == s || v == t) {
+        continue;
+      }
+      if (source_edge[u] == -1 || sink_edge[v] == -1) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * BFS from all unmatched left nodes, alternating between unmatched edges
+   * from the left and matched edges back from the right. The level of a left
+   * node is the number of matched edges on a shortest alternating path to it.
+   * The BFS stops after the first level with an edge to an unmatched right
+   * node, so only shortest augmenting paths are found in a phase.
+   *
+   * Output: true if some unmatched right node is reachable, i.e. there is an
+   *         augmenting path
+   *
+   * Time complexity: O(|V|+|E|)
+   */
+  bool build_levels() {
+    queue.clear();
+    for (int u = 0; u < n; u++) {
+      level[u] = -1;
+      if (source_edge[u] != -1 && match_edge[u] == -1) {
+        level[u] = 0;
+        queue.push_back(u);
+      }
+    }
+
+    last_level = -1;
+    for (int i = 0; i < queue.size(); i++) {
+      int u = queue[i];
+      if (last_level != -1 && level[u] > last_level) {
+        break;
+      }
+      for (int e = network.first_edge[u]; e < network.first_edge[u + 1]; e++) {
+        if (network.capacity[e] == 0) {
+          continue;
+        }
+        int w = match_left[network.head[e]];
+        if (w == -1) {
+          last_level = level[u];
+        }
+        else if (level[w] == -1) {
+          level[w] = level[u] + 1;
+          queue.push_back(w);
+        }
+      }
+    }
+    return last_level != -1;
+  }
+
+  /**
+   * Finds an augmenting path from the unmatched left node root along which
+   * the levels increase by one up to last_level, where it ends in an
+   * unmatched right node, and flips the matching along it. Dead ends
+   * get level -1 and the current-arc pointers skip edges that have already
+   * been tried, so a phase looks at every edge O(1) times.
+   *
+   * Output: true if the matching was augmented
+   *
+   * Time complexity: O(|V|+|E|) for all calls in a phase together
+   */
+  bool augment(int root) {
+    vector<int> &stack = queue;
+    stack.clear();
+    stack.push_back(root);
+    while (!stack.empty()) {
+      int u = stack.back();
+      int &e = current_arc[u];
+      for (; e < network.first_edge[u + 1]; e++) {
+        if (network.capacity[e] == 0) {
+          continue;
+        }
+        int w = match_left[network.head[e]];
+        if (w == -1 && level[u] == last_level) {
+          // Flip the matching along the path: every left node on the stack is
+          // matched to the right node its current arc points to
+          for (int x : stack) {
+            int f = current_arc[x];
+            match_edge[x] = f;
+            match_left[network.head[f]] = x;
+          }
+          return true;
+        }
+        if (w != -1 && level[u] < last_level && level[w] == level[u] + 1) {
+          break;
+        }
+      }
+
+      if (e < network.first_edge[u + 1]) {
+        stack.push_back(match_left[network.head[e]]);
+      }
+      else {
+        level[u] = -1;
+        stack.pop_back();
+        if (!stack.empty()) {
+          current_arc[stack.back()]++;
+        }
+      }
+    }
+    return false;
+  }
+
+  /**
+   * Hopcroft-Karp: in every phase, find a maximal set of vertex disjoint
+   * shortest augmenting paths and augment along all of them. There are
+   * O(sqrt(|V|)) phases of O(|E|) each.
+   *
+   * The matching is written to the residual graph as a flow of one unit along
+   * s->u->v->t for every matched pair (u, v).
+   *
+   * Output: the size of the maximum matching, i.e. the max flow
+   */
+  i64 solve() {
+    i64 matched = 0;
+    while (build_levels()) {
+      for (int u = 0; u < n; u++) {
+        current_arc[u] = network.first_edge[u];
+      }
+      for (int u = 0; u < n; u++) {
+        if (level[u] == 0 && augment(u)) {
+          matched++;
+        }
+      }
+    }
+
+    for (int u = 0; u < n; u++) {
+      if (match_edge[u] != -1) {
+        network.push(source_edge[u], 1);
+        network.push(match_edge[u], 1);
+        network.push(sink_edge[network.head[match_edge[u]]], 1);
+      }
+    }
+    return matched;
+  }
+};
+
+/**
+ * Solves the max flow problem for a unit capacity bipartite network as a
+ * maximum matching. This modifies the residual capacities of the given
+ * network, which must carry no flow.
+ *
+ * Output: Max flow of the network, or -1 if it is not a unit capacity
+ *         bipartite network with source s and sink t
+ */
+i64 hopcroft_karp(FlowNetwork &network, int s, int t) {
+  HopcroftKarp solver = HopcroftKarp(network, s, t);
+  if (!solver.is_unit_bipartite()) {
+    return -1;
+  }
+  return solver.solve();
+}
@@ -0,0 +1,158 @@
+/**
+ * Johannes Kung johku144
+ *
+ * Maximum flow using Dinic's algorithm on a CSR residual graph.
+ *
+ * Time complexity: O(|V|^2*|E|) in general, O(|E|*sqrt(|V|)) on unit capacity
+ *                  networks (see dinic())
+ * Memory consumption: O(|V|) on top of the residual graph
+ *  - Level of every node O(|V|)
+ *  - Current-arc pointer of every node O(|V|)
+ *  - DFS stack O(|V|)
+ */
+#pragma once
+#include <limits>
+#include <vector>
+#include "flow_network.h"
+
+using namespace std;
+
+/**
+ * Performs BFS from the source in the residual graph, consisting of all edges
+ * with residual capacity > 0, and stores the distance to every node in "level".
+ * Nodes that cannot be reached get level -1.
+ *
+ * Output: true if the sink can be reached, i.e. there is an augmenting path
+ *
+ * Time complexity: O(|V|+|E|) as every edge may be visited once
+ */
+bool build_level_graph(FlowNetwork &network, vector<int> &level, vector<int> &queue, int s, int t) {
+  fill(level.begin(), level.end(), -1);
+  level[s] = 0;
+  queue.clear();
+  queue.push_back(s);
+  for (int i = 0; i < queue.size() && level[t] == -1; i++) {
+    int node = queue[i];
+    for (int e = network.first_edge[node]; e < network.first_edge[node + 1]; e++) {
+      int neighbour = network.head[e];
+      if (level[neighbour] == -1 && network.residual[e] > 0) {
+        level[neighbour] = level[node] + 1;
+        queue.push_back(neighbour);
+      }
+    }
+  }
+  return level[t] != -1;
+}
+
+/**
+ * Finds a blocking flow in the level graph, i.e. flow along paths where every
+ * edge goes from level l to level l+1, such that every such path from s to t
+ * has a saturated edge. The flow is added to the residual graph.
+ *
+ * The DFS is iterative and keeps a current-arc pointer for every node: an edge
+ * that has been found to lead to a dead end or that has been saturated is
+ * never looked at again during this phase. The path is stored as a stack of
+ * residual edge indices.
+ *
+ * At most "limit" units of flow are sent.
+ *
+ * Output: the value of the blocking flow
+ *
+ * Time complexity: O(|V|*|E|) as every augmenting path is found in O(|V|)
+ *                  amortised and removes at least one edge from the level graph
+ */
+i64 blocking_flow(
+    FlowNetwork &network,
+    vector<int> &level,
+    vector<int> &current_arc,
+    vector<int> &path,
+    int s,
+    int t,
+    i64 limit
+    ) {
+  for (int u = 0; u < network.nodes; u++) {
+    current_arc[u] = network.first_edge[u];
+  }
+
+  i64 total_flow = 0;
+  path.clear();
+  int node = s;
+  while (total_flow < limit) {
+    if (node == t) {
+      // Augment along the path by the lowest residual capacity on it, then
+      // retreat to the tail of the first saturated edge
+      i64 flow = limit - total_flow;
+      for (int e : path) {
+        flow = min(flow, network.residual[e]);
+      }
+      int first_saturated = path.size();
+      for (int i = 0; i < path.size(); i++) {
+        network.push(path[i], flow);
+        if (network.residual[path[i]] == 0 && first_saturated == path.size()) {
+          first_saturated = i;
+        }
+      }
+      total_flow += flow;
+      path.resize(first_saturated);
+      node = path.empty() ? s : network.head[path.back()];
+      continue;
+    }
+
+    // Advance along the first admissible edge from the current arc onwards
+    bool advanced = false;
+    for (int &e = current_arc[node]; e < network.first_edge[node + 1]; e++) {
+      if (network.residual[e] > 0 && level[network.head[e]] == level[node] + 1) {
+        path.push_back(e);
+        node = network.head[e];
+        advanced = true;
+        break;
+      }
+    }
+
+    if (!advanced) {
+      // Dead end: no path to t goes through this node in the level graph.
+      // Retreat and skip the edge that led here
+      if (node == s) {
+        break;
+      }
+      level[node] = -1;
+      node = network.tail(path.back());
+      path.pop_back();
+      current_arc[node]++;
+    }
+  }
+  return total_flow;
+}
+
+/**
+ * Implements Dinic's algorithm to solve the max flow problem for a given flow
+ * network. This modifies the residual capacities of the given network.
+ *
+ * Repeatedly builds the level graph using BFS and then saturates it with a
+ * blocking flow. The distance from s to t in the residual graph strictly
+ * increases after every phase, so there are at most |V| phases, each costing
+ * O(|V|*|E|). This yields a time complexity of O(|V|^2*|E|).
+ *
+ * The flow already present in the residual graph is kept and only augmented,
+ * so the function may be called again after the network has been changed.
+ * If a limit is given, at most that much flow is added. No flow is added if
+ * s == t.
+ *
+ * Output: The flow added to the network, i.e. the max flow if the network
+ *         had no flow before
+ */
+i64 dinic(FlowNetwork &network, int s, int t, i64 limit = numeric_limits<i64>::max()) {
+  if (s == t) {
+    return 0;
+  }
+  vector<int> level = vector<int>(network.nodes);
+  vector<int> current_arc = vector<int>(network.nodes);
+  vector<int> queue;
+  vector<int> path;
+
+  i64 total_flow = 0;
+  while (total_flow < limit && build_level_graph(network, level, queue, s, t)) {
+    total_flow += blocking_flow(network, level, current_arc, path, s, t, limit - total_flow);
+  }
+  return total_flow;
+}
@@ -0,0 +1,110 @@
+/**
+ * Johannes Kung johku144
+ *
+ * Warm-started max flow for a network whose capacities change between solves.
+ *
+ * The residual graph is kept between calls to solve(). Changing the capacity
+ * of an edge only repairs the flow locally, after which solve() augments the
+ * current flow with Dinic's algorithm instead of starting from zero.
+ *
+ * Time complexity: set_capacity() and solve() are O(|V|^2*|E|) in the worst
+ *                  case, but only do work proportional to the change in flow
+ *                  in practice
+ * Memory consumption: O(|V|+|E|)
+ */
+#pragma once
+#include <tuple>
+#include <vector>
+#include "flow_network.h"
+#include "dinic.h"
+
+using namespace std;
+
+class IncrementalMaxFlow {
+  FlowNetwork network;
+  int s;
+  int t;
+
+public:
+  IncrementalMaxFlow(int nodes, vector<tuple<int, int, i64>> &edges, int s, int t)
+    : network(nodes, edges), s(s), t(t) {}
+
+  /**
+   * Changes the capacity of the input edge with the given index.
+   *
+   * If the edge carries more flow than its new capacity, the excess flow is
+   * first rerouted around the edge in the residual graph. Whatever cannot be
+   * rerouted is pushed back: from the tail of the edge back to the source and
+   * from the sink back to the head of the edge, which lowers the flow value.
+   * Increases only add residual capacity; the extra flow is found by solve().
+   *
+   * Time complexity: O(1) if the flow on the edge still fits, otherwise three
+   *                  limited Dinic runs
+   */
+  void set_capacity(int edge, i64 capacity) {
+    int e = network.edge_index[edge];
+    int rev = network.reverse[e];
+    i64 flow = network.residual[rev] - network.capacity[rev];
+
+    if (flow <= capacity) {
+      network.capacity[e] = capacity;
+      network.residual[e] = capacity - flow;
+      return;
+    }
+
+    // Lower the flow on the edge to its new capacity. This leaves the tail u
+    // with more flow in than out and the head v with more flow out than in
+    i64 excess = flow - capacity;
+    network.capacity[e] = capacity;
+    network.residual[e] = 0;
+    network.residual[rev] = network.capacity[rev] + capacity;
+    int u = network.tail(e);
+    int v = network.head[e];
+
+    // Send as much of the excess as possible from u to v along other paths.
+    // Afterwards no flow goes from v to u, so all flow into u that is left to
+    // remove comes from the source and all flow out of v that is left to
+    // remove goes to the sink
+    if (u != v) {
+      excess -= dinic(network, u, v, excess);
+    }
+    if (excess > 0 && u != s && u != t) {
+      dinic(network, u, s, excess);
+    }
+    if (excess > 0 && v != s && v != t) {
+      dinic(network, t, v, excess);
+    }
+  }
+
+  /**
+   * Augments the current flow to a max flow.
+   *
+   * Output: Max flow of the network
+   */
+  i64 solve() {
+    if (s != t) {
+      dinic(network, s, t);
+    }
+    return flow_value();
+  }
+
+  /**
+   * Returns the value of the current flow: the net flow out of the source.
+   *
+   * Time complexity: O(deg(s))
+   */
+  i64 flow_value() {
+    i64 value = 0;
+    for (int e = network.first_edge[s]; e < network.first_edge[s + 1]; e++) {
+      value += network.capacity[e] - network.residual[e];
+    }
+    return value;
+  }
+
+  /**
+   * Returns the flow on every input edge with a flow > 0 (see get_flows()).
+   */
+  vec_flows get_flows() {
+    return network.get_flows();
+  }
+};
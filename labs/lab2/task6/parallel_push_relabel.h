@@ -0,0 +1,334 @@
+/**
+ * Johannes Kung johku144
+ *
+ * Maximum flow using a parallel, synchronous push-relabel algorithm on the
+ * same CSR residual graph as the sequential solvers.
+ *
+ * The algorithm works in rounds. In every round all active nodes are
+ * discharged concurrently using the labels from the start of the round:
+ *  1. Push phase: every active node pushes its excess along admissible edges.
+ *     An edge u->v and its pair v->u can never both be admissible as that
+ *     would require label(u) = label(v)+1 and label(v) = label(u)+1. Every
+ *     residual edge pair is therefore modified by at most one thread, so the
+ *     pushes need no locks. Excess received by a node is added atomically to
+ *     a separate counter and only becomes available in the next round.
+ *  2. Relabel phase: every node that still has excess is relabelled, reading
+ *     the residual graph as it is after all pushes and the labels from the
+ *     start of the round. The new labels are applied after the round.
+ *
+ * The outcome of a round does not depend on how the nodes are divided among
+ * the threads or in which order they are handled, so both the flow value and
+ * the flow on every edge are deterministic for any number of threads.
+ *
+ * Global relabelling is done by a level-synchronous parallel BFS from the
+ * target, initially and every n relabels.
+ *
+ * max_flow does not offer this solver: it has only been measured on a single
+ * core, where it is slower than push_relabel() for every thread count.
+ *
+ * Time complexity: O(|V|^2*|E|) rounds of work in total, divided among the
+ *                  threads, with O(|V|^2) rounds in the worst case
+ * Memory consumption: O(|V|) on top of the residual graph
+ */
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "flow_network.h"
+
+using namespace std;
+
+/**
+ * Reusable barrier: wait() blocks until all threads have called it.
+ */
+class Barrier {
+  mutex m;
+  condition_variable cv;
+  int threads;
+  int waiting = 0;
+  int generation = 0;
+
+public:
+  Barrier(int threads) : threads(threads) {}
+
+  void wait() {
+    unique_lock<mutex> lock(m);
+    int gen = generation;
+    if (++waiting == threads) {
+      waiting = 0;
+      generation++;
+      cv.notify_all();
+    }
+    else {
+      cv.wait(lock, [&] { return gen != generation; });
+    }
+  }
+};
+
+struct ParallelPushRelabel {
+  FlowNetwork &network;
+  int n;
+  int threads;
+  Barrier barrier;
+
+  vector<int> label;
+  vector<int> new_label;
+  vector<i64> excess;
+
+  // Excess received during the current round
+  vector<atomic<i64>> incoming;
+
+  // Whether a node has been put in the active list of the next round
+  vector<atomic<char>> queued;
+
+  // Nodes to discharge in the current round, and per thread the nodes that
+  // may be active in the next round and the nodes relabelled this round
+  vector<int> active;
+  vector<vector<int>> next_active;
+  vector<vector<int>> relabelled;
+
+  // Frontiers of the parallel BFS used for global relabelling
+  vector<int> frontier;
+  vector<vector<int>> next_frontier;
+  vector<atomic<char>> visited;
+
+  int relabels;
+
+  ParallelPushRelabel(FlowNetwork &network, int threads)
+    : network(network),
+      n(network.nodes),
+      threads(threads),
+      barrier(threads),
+      label(n),
+      new_label(n),
+      excess(n, 0),
+      incoming(n),
+      queued(n),
+      next_active(threads),
+      relabelled(threads),
+      next_frontier(threads),
+      visited(n) {
+    for (int u = 0; u < n; u++) {
+      incoming[u].store(0);
+      queued[u].store(0);
+    }
+  }
+
+  /**
+   * Global relabelling, executed by every thread: sets the label of every
+   * node to its distance to the target in the residual graph, or n if it
+   * cannot reach the target. The BFS proceeds one level at a time with the
+   * frontier split among the threads. A node is claimed by the first thread
+   * to set its visited flag.
+   *
+   * Time complexity: O(|V|+|E|) work, O(BFS depth) barriers
+   */
+  void global_relabel(int tid, int source, int target) {
+    for (int u = tid; u < n; u += threads) {
+      label[u] = n;
+      visited[u].store(0, memory_order_relaxed);
+    }
+    barrier.wait();
+    if (tid == 0) {
+      label[target] = 0;
+      visited[target] = 1;
+      visited[source] = 1;
+      frontier = {target};
+      relabels = 0;
+    }
+    barrier.wait();
+
+    int level = 0;
+    while (!frontier.empty()) {
+      for (int i = tid; i < frontier.size(); i += threads) {
+        int v = frontier[i];
+        for (int e = network.first_edge[v]; e < network.first_edge[v + 1]; e++) {
+          int u = network.head[e];
+          if (network.residual[network.reverse[e]] > 0
+              && visited[u].load(memory_order_relaxed) == 0
+              && visited[u].exchange(1) == 0) {
+            label[u] = level + 1;
+            next_frontier[tid].push_back(u);
+          }
+        }
+      }
+      barrier.wait();
+      if (tid == 0) {
+        frontier.clear();
+        for (vector<int> &next : next_frontier) {
+          frontier.insert(frontier.end(), next.begin(), next.end());
+          next.clear();
+        }
+      }
+      level++;
+      barrier.wait();
+    }
+
+    if (tid == 0) {
+      active.clear();
+      for (int u = 0; u < n; u++) {
+        if (excess[u] > 0 && label[u] < n && u != source && u != target) {
+          active.push_back(u);
+        }
+      }
+    }
+    barrier.wait();
+  }
+
+  /**
+   * Pushes the excess u has at the start of the round along admissible edges.
+   */
+  void push_from(int tid, int u, int source, int target) {
+    for (int e = network.first_edge[u]; e < network.first_edge[u + 1] && excess[u] > 0; e++) {
+      int v = network.head[e];
+      // Check the labels first: the residual capacity may only be read if
+      // the edge is admissible, otherwise v might be pushing along the pair
+      if (label[u] == label[v] + 1 && network.residual[e] > 0) {
+        i64 flow = min(excess[u], network.residual[e]);
+        network.push(e, flow);
+        excess[u] -= flow;
+        incoming[v].fetch_add(flow, memory_order_relaxed);
+        if (v != source && v != target && queued[v].exchange(1) == 0) {
+          next_active[tid].push_back(v);
+        }
+      }
+    }
+  }
+
+  /**
+   * Computes the new label of u from the labels at the start of the round.
+   */
+  void relabel(int tid, int u) {
+    int lowest = n;
+    for (int e = network.first_edge[u]; e < network.first_edge[u + 1]; e++) {
+      if (network.residual[e] > 0) {
+        lowest = min(lowest, label[network.head[e]] + 1);
+      }
+    }
+    new_label[u] = lowest;
+    relabelled[tid].push_back(u);
+    if (queued[u].exchange(1) == 0) {
+      next_active[tid].push_back(u);
+    }
+  }
+
+  /**
+   * Executed by thread 0 between rounds: applies the new labels and the
+   * received excess and collects the active nodes of the next round.
+   */
+  void finish_round(int source, int target) {
+    for (vector<int> &nodes : relabelled) {
+      for (int u : nodes) {
+        label[u] = new_label[u];
+      }
+      relabels += nodes.size();
+      nodes.clear();
+    }
+
+    active.clear();
+    for (vector<int> &nodes : next_active) {
+      for (int u : nodes) {
+        queued[u] = 0;
+        excess[u] += incoming[u].exchange(0, memory_order_relaxed);
+        if (excess[u] > 0 && label[u] < n) {
+          active.push_back(u);
+        }
+      }
+      nodes.clear();
+    }
+    excess[source] += incoming[source].exchange(0, memory_order_relaxed);
+    excess[target] += incoming[target].exchange(0, memory_order_relaxed);
+  }
+
+  /**
+   * The work of a single thread: rounds of pushes and relabels on its share
+   * of the active nodes until there are no active nodes left.
+   */
+  void run(int tid, int source, int target) {
+    global_relabel(tid, source, target);
+    while (!active.empty()) {
+      for (int i = tid; i < active.size(); i += threads) {
+        push_from(tid, active[i], source, target);
+      }
+      barrier.wait();
+
+      for (int i = tid; i < active.size(); i += threads) {
+        if (excess[active[i]] > 0) {
+          relabel(tid, active[i]);
+        }
+      }
+      barrier.wait();
+
+      if (tid == 0) {
+        finish_round(source, target);
+      }
+      barrier.wait();
+
+      if (relabels >= n) {
+        global_relabel(tid, source, target);
+      }
+    }
+  }
+
+  void discharge_all(int source, int target) {
+    vector<thread> workers;
+    for (int tid = 1; tid < threads; tid++) {
+      workers.push_back(thread(&ParallelPushRelabel::run, this, tid, source, target));
+    }
+    run(0, source, target);
+    for (thread &worker : workers) {
+      worker.join();
+    }
+  }
+
+  /**
+   * Phase 1: computes a maximum preflow from s to t.
+   *
+   * Output: the value of a max flow, i.e. the excess of t
+   */
+  i64 preflow(int s, int t) {
+    for (int e = network.first_edge[s]; e < network.first_edge[s + 1]; e++) {
+      i64 flow = network.residual[e];
+      if (flow > 0) {
+        network.push(e, flow);
+        excess[s] -= flow;
+        excess[network.head[e]] += flow;
+      }
+    }
+    discharge_all(s, t);
+    return excess[t];
+  }
+
+  /**
+   * Phase 2: returns all excess that did not reach t back to s.
+   */
+  void preflow_to_flow(int s, int t) {
+    discharge_all(t, s);
+  }
+};
+
+/**
+ * Solves the max flow problem for a given flow network using parallel
+ * push-relabel with the given number of threads. This modifies the residual
+ * capacities of the given network.
+ *
+ * If preflow_only is set, the second phase is skipped (see push_relabel()).
+ *
+ * Output: Max flow of the network
+ */
+i64 parallel_push_relabel(
+    FlowNetwork &network,
+    int s,
+    int t,
+    int threads = max(1u, thread::hardware_concurrency()),
+    bool preflow_only = false
+    ) {
+  ParallelPushRelabel solver = ParallelPushRelabel(network, threads);
+  i64 total_flow = solver.preflow(s, t);
+  if (!preflow_only) {
+    solver.preflow_to_flow(s, t);
+  }
+  return total_flow;
+}
@@ -0,0 +1,313 @@
+/**
+ * Johannes Kung johku144
+ *
+ * Maximum flow using the highest-label push-relabel algorithm on a CSR
+ * residual graph, with the gap and global relabelling heuristics.
+ *
+ * The algorithm runs in two phases:
+ *  1. Compute a maximum preflow: flow is pushed from nodes with excess
+ *     towards the sink until no node with excess can reach the sink. The
+ *     excess of the sink is then the value of a max flow and the nodes that
+ *     cannot reach the sink form the source side of a min cut.
+ *  2. Return the excess of every remaining node to the source, turning the
+ *     preflow into a flow. This phase is only needed for the flow on every
+ *     edge, not for the flow value or the min cut.
+ *
+ * Time complexity: O(|V|^2*sqrt(|E|)) (see discharge_all())
+ * Memory consumption: O(|V|) on top of the residual graph
+ */
+#pragma once
+#include <vector>
+#include "flow_network.h"
+
+using namespace std;
+
+struct PushRelabel {
+  FlowNetwork &network;
+  int n;
+
+  // Distance label and excess flow of every node
+  vector<int> label;
+  vector<i64> excess;
+  vector<int> current_arc;
+
+  // Nodes with excess > 0 and a label < n are active. They are kept in one
+  // singly linked list per label so that the one with the highest label can be
+  // found quickly
+  vector<int> active_head;
+  vector<int> active_next;
+  int highest_active;
+
+  // All nodes with a label < n are kept in one doubly linked list per label,
+  // used by the gap heuristic to find every node above an empty label
+  vector<int> label_head;
+  vector<int> label_next;
+  vector<int> label_prev;
+  int highest_label;
+
+  // Number of relabels since the last global relabelling
+  int relabels;
+
+  PushRelabel(FlowNetwork &network) : network(network), n(network.nodes) {
+    label = vector<int>(n);
+    excess = vector<i64>(n, 0);
+    current_arc = vector<int>(n);
+    active_head = vector<int>(n + 1);
+    active_next = vector<int>(n);
+    label_head = vector<int>(n + 1);
+    label_next = vector<int>(n);
+    label_prev = vector<int>(n);
+  }
+
+  void add_active(int u) {
+    active_next[u] = active_head[label[u]];
+    active_head[label[u]] = u;
+    highest_active = max(highest_active, label[u]);
+  }
+
+  void add_to_label(int u) {
+    int l = label[u];
+    label_prev[u] = -1;
+    label_next[u] = label_head[l];
+    if (label_head[l] != -1) {
+      label_prev[label_head[l]] = u;
+    }
+    label_head[l] = u;
+    highest_label = max(highest_label, l);
+  }
+
+  void remove_from_label(int u) {
+    if (label_prev[u] != -1) {
+      label_next[label_prev[u]] = label_next[u];
+    }
+    else {
+      label_head[label[u]] = label_next[u];
+    }
+    if (label_next[u] != -1) {
+      label_prev[label_next[u]] = label_prev[u];
+    }
+  }
+
+  /**
+   * Global relabelling: sets the label of every node to its exact distance to
+   * the target in the residual graph using a backward BFS from the target.
+   * Nodes that cannot reach the target get label n and are thereby inactive.
+   * The active lists and label lists are rebuilt.
+   *
+   * Time complexity: O(|V|+|E|)
+   */
+  void global_relabel(int source, int target) {
+    fill(label.begin(), label.end(), n);
+    fill(active_head.begin(), active_head.end(), -1);
+    fill(label_head.begin(), label_head.end(), -1);
+    highest_active = 0;
+    highest_label = 0;
+    relabels = 0;
+
+    vector<int> queue = {target};
+    label[target] = 0;
+    for (int i = 0; i < queue.size(); i++) {
+      int v = queue[i];
+      for (int e = network.first_edge[v]; e < network.first_edge[v + 1]; e++) {
+        // The paired edge goes from u to v, so u can reach v if it has
+        // residual capacity
+        int u = network.head[e];
+        if (label[u] == n && u != source && network.residual[network.reverse[e]] > 0) {
+          label[u] = label[v] + 1;
+          queue.push_back(u);
+        }
+      }
+    }
+
+    for (int u = 0; u < n; u++) {
+      current_arc[u] = network.first_edge[u];
+      if (label[u] < n && u != target) {
+        add_to_label(u);
+        if (excess[u] > 0) {
+          add_active(u);
+        }
+      }
+    }
+  }
+
+  /**
+   * Gap heuristic: no node has the given label, so no node above it can reach
+   * the target. Set the label of all of them to n, making them inactive.
+   *
+   * Time complexity: O(number of relabelled nodes)
+   */
+  void gap(int empty_label) {
+    for (int l = empty_label + 1; l <= highest_label; l++) {
+      for (int u = label_head[l]; u != -1; u = label_next[u]) {
+        label[u] = n;
+      }
+      label_head[l] = -1;
+    }
+    highest_label = empty_label - 1;
+  }
+
+  /**
+   * Relabels u to one more than the lowest label of a node it has a residual
+   * edge to, the highest label that keeps the labelling valid.
+   *
+   * Time complexity: O(deg(u))
+   */
+  void relabel(int u) {
+    relabels++;
+    int old_label = label[u];
+    remove_from_label(u);
+
+    int new_label = n;
+    for (int e = network.first_edge[u]; e < network.first_edge[u + 1]; e++) {
+      if (network.residual[e] > 0) {
+        new_label = min(new_label, label[network.head[e]] + 1);
+      }
+    }
+    label[u] = new_label;
+    current_arc[u] = network.first_edge[u];
+
+    if (label_head[old_label] == -1) {
+      // u was the only node with its old label
+      label[u] = n;
+      gap(old_label);
+    }
+    else if (new_label < n) {
+      add_to_label(u);
+    }
+  }
+
+  /**
+   * Pushes flow out of u along admissible edges, i.e. residual edges to nodes
+   * with a label one lower, relabelling u whenever there are none left, until
+   * u has no excess or has a label >= n.
+   */
+  void discharge(int u, int source, int target) {
+    while (excess[u] > 0) {
+      int end = network.first_edge[u + 1];
+      int &e = current_arc[u];
+      for (; e < end && excess[u] > 0; e++) {
+        int v = network.head[e];
+        if (network.residual[e] > 0 && label[u] == label[v] + 1) {
+          i64 flow = min(excess[u], network.residual[e]);
+          network.push(e, flow);
+          excess[u] -= flow;
+          if (excess[v] == 0 && v != source && v != target && label[v] < n) {
+            add_active(v);
+          }
+          excess[v] += flow;
+          if (excess[u] == 0) {
+            break;
+          }
+        }
+      }
+      if (excess[u] == 0) {
+        break;
+      }
+      relabel(u);
+      if (label[u] >= n) {
+        break;
+      }
+    }
+  }
+
+  /**
+   * Discharges the active node with the highest label until there are no
+   * active nodes left. A global relabelling is done every n relabels.
+   *
+   * Time complexity: O(|V|^2*sqrt(|E|)) for highest-label selection
+   */
+  void discharge_all(int source, int target) {
+    global_relabel(source, target);
+    while (true) {
+      while (highest_active >= 0 && active_head[highest_active] == -1) {
+        highest_active--;
+      }
+      if (highest_active < 0) {
+        break;
+      }
+
+      int u = active_head[highest_active];
+      active_head[highest_active] = active_next[u];
+      if (label[u] != highest_active || excess[u] == 0) {
+        // Stale entry: u has been relabelled by the gap heuristic or emptied
+        continue;
+      }
+
+      discharge(u, source, target);
+
+      if (relabels >= n) {
+        global_relabel(source, target);
+      }
+    }
+  }
+
+  /**
+   * Phase 1: computes a maximum preflow from s to t.
+   *
+   * Output: the value of a max flow, i.e. the excess of t
+   */
+  i64 preflow(int s, int t) {
+    fill(excess.begin(), excess.end(), 0);
+    for (int e = network.first_edge[s]; e < network.first_edge[s + 1]; e++) {
+      i64 flow = network.residual[e];
+      if (flow > 0) {
+        network.push(e, flow);
+        excess[s] -= flow;
+        excess[network.head[e]] += flow;
+      }
+    }
+    discharge_all(s, t);
+    return excess[t];
+  }
+
+  /**
+   * Phase 2: returns all excess that did not reach t back to s. A node with
+   * excess always has a residual path back to s, so discharging towards s
+   * with labels measured as distances to s leaves no excess behind.
+   */
+  void preflow_to_flow(int s, int t) {
+    discharge_all(t, s);
+  }
+
+  /**
+   * Returns whether every node can reach t in the residual graph. After
+   * preflow() the nodes that cannot reach t form the source side of a min cut.
+   *
+   * Time complexity: O(|V|+|E|)
+   */
+  vector<bool> can_reach(int t) {
+    vector<bool> reached = vector<bool>(n, false);
+    reached[t] = true;
+    vector<int> queue = {t};
+    for (int i = 0; i < queue.size(); i++) {
+      int v = queue[i];
+      for (int e = network.first_edge[v]; e < network.first_edge[v + 1]; e++) {
+        int u = network.head[e];
+        if (!reached[u] && network.residual[network.reverse[e]] > 0) {
+          reached[u] = true;
+          queue.push_back(u);
+        }
+      }
+    }
+    return reached;
+  }
+};
+
+/**
+ * Solves the max flow problem for a given flow network using push-relabel.
+ * This modifies the residual capacities of the given network.
+ *
+ * If preflow_only is set, the second phase is skipped: the returned value is
+ * still the max flow and the residual graph still describes a min cut, but the
+ * flow on the edges does not satisfy flow conservation.
+ *
+ * Output: Max flow of the network
+ */
+i64 push_relabel(FlowNetwork &network, int s, int t, bool preflow_only = false) {
+  PushRelabel solver = PushRelabel(network);
+  i64 total_flow = solver.preflow(s, t);
+  if (!preflow_only) {
+    solver.preflow_to_flow(s, t);
+  }
+  return total_flow;
+}
@@ -0,0 +1,214 @@
+/**
+ * Johannes Kung johku144
+ *
+ * Residual graph of a flow network stored in Compressed Sparse Row (CSR)
+ * format. Every edge u->v of the input gets a forward residual edge stored
+ * among the edges leaving u and a paired reverse residual edge v->u stored
+ * among the edges leaving v. The index of the paired edge is kept so that
+ * pushing flow along an edge is O(1).
+ *
+ * Memory consumption: O(|V|+|E|)
+ */
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using namespace std;
+using i64 = int64_t;
+
+// List of flows between pairs of nodes, reresented using tuple
+// First is node 1, second is node 2, third is flow from node 1 to node 2
+using vec_flows = vector<tuple<int, int, i64>>;
+
+// List of flow paths, each given by its flow and the nodes along it
+using vec_paths = vector<pair<i64, vector<int>>>;
+
+struct FlowNetwork {
+  int nodes;
+
+  // The residual edges leaving node u are those with indices
+  // first_edge[u], ..., first_edge[u+1]-1
+  vector<int> first_edge;
+
+  // For every residual edge: the node it points to, its paired reverse edge,
+  // its capacity (0 for reverse edges) and its residual capacity
+  vector<int> head;
+  vector<int> reverse;
+  vector<i64> capacity;
+  vector<i64> residual;
+
+  // The index of the forward residual edge of every input edge, in input order
+  vector<int> edge_index;
+
+  /**
+   * Constructs the residual graph of a flow network given as a list of
+   * directed edges (u, v, capacity).
+   *
+   * Time complexity: O(|V|+|E|) using a counting sort on the tail of every
+   * residual edge
+   */
+  FlowNetwork(int nodes, vector<tuple<int, int, i64>> &edges) : nodes(nodes) {
+    int m = edges.size();
+    first_edge = vector<int>(nodes + 1, 0);
+    for (auto &e : edges) {
+      first_edge[get<0>(e) + 1]++;
+      first_edge[get<1>(e) + 1]++;
+    }
+    for (int u = 0; u < nodes; u++) {
+      first_edge[u + 1] += first_edge[u];
+    }
+
+    head = vector<int>(2*m);
+    reverse = vector<int>(2*m);
+    capacity = vector<i64>(2*m, 0);
+    residual = vector<i64>(2*m, 0);
+    edge_index = vector<int>(m);
+
+    vector<int> next = vector<int>(first_edge.begin(), first_edge.end() - 1);
+    for (int i = 0; i < m; i++) {
+      int u = get<0>(edges[i]);
+      int v = get<1>(edges[i]);
+      int forward = next[u]++;
+      int backward = next[v]++;
+
+      head[forward] = v;
+      reverse[forward] = backward;
+      capacity[forward] = get<2>(edges[i]);
+      residual[forward] = get<2>(edges[i]);
+
+      head[backward] = u;
+      reverse[backward] = forward;
+
+      edge_index[i] = forward;
+    }
+  }
+
+  int tail(int e) {
+    return head[reverse[e]];
+  }
+
+  /**
+   * Sends the given amount of flow along residual edge e.
+   */
+  void push(int e, i64 flow) {
+    residual[e] -= flow;
+    residual[reverse[e]] += flow;
+  }
+
+  /**
+   * Restores the residual graph to the zero flow.
+   */
+  void reset() {
+    residual = capacity;
+  }
+
+  /**
+   * Returns the flow on every input edge with a flow > 0, in input order. The
+   * flow is the capacity of the edge subtracted by the residual (unused)
+   * capacity. Parallel edges are reported separately.
+   *
+   * Time complexity: O(|E|)
+   */
+  vec_flows get_flows() {
+    vec_flows flows;
+    for (int e : edge_index) {
+      i64 flow = capacity[e] - residual[e];
+      if (flow > 0) {
+        flows.push_back({tail(e), head[e], flow});
+      }
+    }
+    return flows;
+  }
+
+  /**
+   * Decomposes the current flow into paths from s to t. Every path is given
+   * by its flow and its nodes, from s to t. Flow on cycles is not part of any
+   * path and is left out.
+   *
+   * Every path is found by following edges with remaining flow from s, using
+   * a current-arc pointer per node so that exhausted edges are skipped for
+   * good. If the walk returns to a node already on the path, the cycle is
+   * cancelled and the walk continues from that node. Every path or cycle
+   * removes the remaining flow of at least one edge.
+   *
+   * Time complexity: O(|V|*|E|)
+   */
+  vec_paths decompose_paths(int s, int t) {
+    vec_paths paths;
+    if (s == t) {
+      return paths;
+    }
+
+    // Flow left to decompose on every residual edge, 0 for reverse edges
+    vector<i64> remaining = vector<i64>(head.size());
+    for (int e : edge_index) {
+      remaining[e] = capacity[e] - residual[e];
+    }
+    vector<int> current_arc = vector<int>(first_edge.begin(), first_edge.end() - 1);
+
+    // The position of every node on the current path, -1 if not on it
+    vector<int> position = vector<int>(nodes, -1);
+    vector<int> path_nodes;
+    vector<int> path_edges;
+    while (true) {
+      path_nodes = {s};
+      path_edges.clear();
+      position[s] = 0;
+      int u = s;
+      while (u != t) {
+        int &e = current_arc[u];
+        while (e < first_edge[u + 1] && remaining[e] == 0) {
+          e++;
+        }
+        if (e == first_edge[u + 1]) {
+          // Only s can run out of outgoing flow, by flow conservation
+          break;
+        }
+
+        int v = head[e];
+        path_edges.push_back(e);
+        if (position[v] == -1) {
+          position[v] = path_nodes.size();
+          path_nodes.push_back(v);
+          u = v;
+          continue;
+        }
+
+        // Cancel the cycle from v back to v
+        i64 flow = remaining[path_edges[position[v]]];
+        for (int i = position[v]; i < path_edges.size(); i++) {
+          flow = min(flow, remaining[path_edges[i]]);
+        }
+        for (int i = position[v]; i < path_edges.size(); i++) {
+          remaining[path_edges[i]] -= flow;
+        }
+        path_edges.resize(position[v]);
+        while (path_nodes.size() > position[v] + 1) {
+          position[path_nodes.back()] = -1;
+          path_nodes.pop_back();
+        }
+        u = v;
+      }
+
+      for (int x : path_nodes) {
+        position[x] = -1;
+      }
+      if (u != t) {
+        break;
+      }
+
+      i64 flow = remaining[path_edges[0]];
+      for (int e : path_edges) {
+        flow = min(flow, remaining[e]);
+      }
+      for (int e : path_edges) {
+        remaining[e] -= flow;
+      }
+      paths.push_back({flow, path_nodes});
+    }
+    return paths;
+  }
+};
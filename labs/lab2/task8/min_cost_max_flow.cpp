@@ -0,0 +1,354 @@
+/**
+ * Johannes Kung johku144
+ *
+ * Minimum cost maximum flow using successive shortest paths with Johnson
+ * potentials and Dijkstra's algorithm, or alternatively Dinic max flow
+ * followed by cost scaling.
+ *
+ * Usage: min_cost_max_flow [--cost-scaling] < input
+ *
+ * Time complexity:
+ *  - Successive shortest paths: O(F*|E|*log(|V|)) where F is the max flow,
+ *    see successive_shortest_paths()
+ *  - Cost scaling: O(|V|^2*|E|*log(|V|*C)) where C is the largest cost,
+ *    see cost_scaling()
+ * Memory consumption: O(|V|+|E|)
+ */
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <ios>
+#include <limits>
+#include <queue>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "flow_network.h"
+#include "dinic.h"
+
+using namespace std;
+
+i64 INFINITE_COST = numeric_limits<i64>::max() / 4;
+
+enum class MinCostAlgorithm {
+  SUCCESSIVE_SHORTEST_PATHS,
+  COST_SCALING,
+};
+
+/**
+ * Returns the cost of every residual edge of the network: the cost of the
+ * input edge for a forward edge and the negated cost for its reverse edge,
+ * as sending flow back along an edge refunds its cost.
+ *
+ * Time complexity: O(|E|)
+ */
+vector<i64> residual_costs(FlowNetwork &network, vector<i64> &edge_costs) {
+  vector<i64> cost = vector<i64>(network.head.size(), 0);
+  for (int i = 0; i < network.edge_index.size(); i++) {
+    int e = network.edge_index[i];
+    cost[e] = edge_costs[i];
+    cost[network.reverse[e]] = -edge_costs[i];
+  }
+  return cost;
+}
+
+/**
+ * Calculates initial potentials as shortest distances from s using the
+ * Bellman-Ford algorithm. Only needed if some edge has a negative cost, as
+ * Dijkstra's algorithm requires non-negative reduced costs.
+ *
+ * Time complexity: O(|V|*|E|)
+ */
+vector<i64> bellman_ford_potentials(FlowNetwork &network, vector<i64> &cost, int s) {
+  vector<i64> distance = vector<i64>(network.nodes, INFINITE_COST);
+  distance[s] = 0;
+  for (int i = 0; i < network.nodes; i++) {
+    bool changed = false;
+    for (int u = 0; u < network.nodes; u++) {
+      if (distance[u] == INFINITE_COST) {
+        continue;
+      }
+      for (int e = network.first_edge[u]; e < network.first_edge[u + 1]; e++) {
+        int v = network.head[e];
+        if (network.residual[e] > 0 && distance[u] + cost[e] < distance[v]) {
+          distance[v] = distance[u] + cost[e];
+          changed = true;
+        }
+      }
+    }
+    if (!changed) {
+      break;
+    }
+  }
+
+  // Nodes that cannot be reached from s will never be on an augmenting path
+  for (i64 &d : distance) {
+    if (d == INFINITE_COST) {
+      d = 0;
+    }
+  }
+  return distance;
+}
+
+/**
+ * Finds a min cost max flow by repeatedly augmenting along a cheapest path
+ * from s to t in the residual graph.
+ *
+ * The shortest paths are found with Dijkstra's algorithm on reduced costs
+ * cost(u, v) + potential(u) - potential(v), which are non-negative as long as
+ * the potentials are shortest distances from s. After every search the
+ * potentials are increased by the distances found, which keeps the reduced
+ * costs of all residual edges non-negative, also the new ones created by the
+ * augmentation as they lie on a shortest path.
+ *
+ * Time complexity: O(F*|E|*log(|V|)) as every augmentation increases the flow
+ *                  by at least 1 and costs one run of Dijkstra
+ */
+pair<i64, i64> successive_shortest_paths(FlowNetwork &network, vector<i64> &cost, int s, int t) {
+  int n = network.nodes;
+  vector<i64> potential = vector<i64>(n, 0);
+  for (int e = 0; e < cost.size(); e++) {
+    if (cost[e] < 0 && network.residual[e] > 0) {
+      potential = bellman_ford_potentials(network, cost, s);
+      break;
+    }
+  }
+
+  vector<i64> distance = vector<i64>(n);
+  vector<int> parent_edge = vector<int>(n);
+  i64 total_flow = 0;
+  i64 total_cost = 0;
+  while (true) {
+    // Dijkstra's algorithm on reduced costs, using a min-heap of
+    // (distance, node) pairs. O(|E|*log(|V|))
+    fill(distance.begin(), distance.end(), INFINITE_COST);
+    fill(parent_edge.begin(), parent_edge.end(), -1);
+    priority_queue<pair<i64, int>, vector<pair<i64, int>>, greater<pair<i64, int>>> to_visit;
+    distance[s] = 0;
+    to_visit.push({0, s});
+    while (!to_visit.empty()) {
+      i64 d = to_visit.top().first;
+      int u = to_visit.top().second;
+      to_visit.pop();
+      if (d > distance[u]) {
+        continue;
+      }
+      for (int e = network.first_edge[u]; e < network.first_edge[u + 1]; e++) {
+        int v = network.head[e];
+        if (network.residual[e] > 0) {
+          i64 new_distance = d + cost[e] + potential[u] - potential[v];
+          if (new_distance < distance[v]) {
+            distance[v] = new_distance;
+            parent_edge[v] = e;
+            to_visit.push({new_distance, v});
+          }
+        }
+      }
+    }
+
+    if (distance[t] == INFINITE_COST) {
+      break;
+    }
+    for (int u = 0; u < n; u++) {
+      if (distance[u] != INFINITE_COST) {
+        potential[u] += distance[u];
+      }
+    }
+
+    // Augment along the cheapest path by its lowest residual capacity
+    i64 flow = numeric_limits<i64>::max();
+    for (int v = t; v != s; v = network.tail(parent_edge[v])) {
+      flow = min(flow, network.residual[parent_edge[v]]);
+    }
+    for (int v = t; v != s; v = network.tail(parent_edge[v])) {
+      network.push(parent_edge[v], flow);
+      total_cost += flow * cost[parent_edge[v]];
+    }
+    total_flow += flow;
+  }
+
+  return {total_flow, total_cost};
+}
+
+/**
+ * One refinement step of cost scaling: turns the current flow into an
+ * eps-optimal one, i.e. one where no residual edge has a reduced cost
+ * below -eps.
+ *
+ * All residual edges with a negative reduced cost are saturated, which leaves
+ * some nodes with excess flow. The excess is then pushed along admissible
+ * edges, residual edges with a negative reduced cost, and a node without any
+ * is relabelled by lowering its price just enough to create one.
+ */
+void refine(
+    FlowNetwork &network,
+    vector<i64> &scaled_cost,
+    vector<i64> &price,
+    vector<i64> &excess,
+    i64 eps
+    ) {
+  int n = network.nodes;
+  auto reduced_cost = [&](int u, int e) {
+    return scaled_cost[e] + price[u] - price[network.head[e]];
+  };
+
+  for (int u = 0; u < n; u++) {
+    for (int e = network.first_edge[u]; e < network.first_edge[u + 1]; e++) {
+      if (network.residual[e] > 0 && reduced_cost(u, e) < 0) {
+        excess[u] -= network.residual[e];
+        excess[network.head[e]] += network.residual[e];
+        network.push(e, network.residual[e]);
+      }
+    }
+  }
+
+  deque<int> active;
+  for (int u = 0; u < n; u++) {
+    if (excess[u] > 0) {
+      active.push_back(u);
+    }
+  }
+
+  vector<int> current_arc = vector<int>(network.first_edge.begin(), network.first_edge.end() - 1);
+  while (!active.empty()) {
+    int u = active.front();
+    active.pop_front();
+
+    while (excess[u] > 0) {
+      int &e = current_arc[u];
+      for (; e < network.first_edge[u + 1]; e++) {
+        if (network.residual[e] > 0 && reduced_cost(u, e) < 0) {
+          int v = network.head[e];
+          i64 flow = min(excess[u], network.residual[e]);
+          network.push(e, flow);
+          excess[u] -= flow;
+          if (excess[v] <= 0 && excess[v] + flow > 0) {
+            active.push_back(v);
+          }
+          excess[v] += flow;
+          if (excess[u] == 0) {
+            break;
+          }
+        }
+      }
+      if (excess[u] == 0) {
+        break;
+      }
+
+      // Relabel: lower the price of u so that the cheapest residual edge out
+      // of u gets reduced cost -eps
+      i64 new_price = -INFINITE_COST;
+      for (int f = network.first_edge[u]; f < network.first_edge[u + 1]; f++) {
+        if (network.residual[f] > 0) {
+          new_price = max(new_price, price[network.head[f]] - scaled_cost[f] - eps);
+        }
+      }
+      price[u] = new_price;
+      current_arc[u] = network.first_edge[u];
+    }
+  }
+}
+
+/**
+ * Finds a min cost max flow by first finding any max flow using Dinic's
+ * algorithm and then cancelling its excess cost with Goldberg-Tarjan cost
+ * scaling. Any two max flows differ by a circulation in the residual graph, so
+ * a min cost circulation in the residual graph of a max flow gives a min cost
+ * max flow.
+ *
+ * Costs are multiplied by n so that a 1-optimal flow for the scaled costs is
+ * (1/n)-optimal for the original integer costs, and therefore optimal. eps is
+ * divided by a constant factor between every refinement, giving
+ * O(log(n*C)) refinements.
+ *
+ * Time complexity: O(|V|^2*|E|*log(|V|*C))
+ */
+pair<i64, i64> cost_scaling(FlowNetwork &network, vector<i64> &cost, int s, int t) {
+  const i64 ALPHA = 8;
+  int n = network.nodes;
+  i64 total_flow = dinic(network, s, t);
+
+  vector<i64> scaled_cost = vector<i64>(cost.size());
+  i64 eps = 0;
+  for (int e = 0; e < cost.size(); e++) {
+    scaled_cost[e] = cost[e] * n;
+    eps = max(eps, abs(scaled_cost[e]));
+  }
+
+  vector<i64> price = vector<i64>(n, 0);
+  vector<i64> excess = vector<i64>(n, 0);
+  while (eps > 1) {
+    eps = max((i64) 1, eps / ALPHA);
+    refine(network, scaled_cost, price, excess, eps);
+  }
+
+  i64 total_cost = 0;
+  for (int e : network.edge_index) {
+    total_cost += (network.capacity[e] - network.residual[e]) * cost[e];
+  }
+  return {total_flow, total_cost};
+}
+
+/**
+ * Solves the min cost max flow problem for a given flow network with a cost
+ * per unit of flow on every edge. This modifies the residual capacities of
+ * the given network.
+ *
+ * Input: flow network as a CSR residual graph, the cost of every input edge,
+ *        source and sink nodes and the algorithm to use
+ * Output: the max flow and its minimal cost
+ */
+pair<i64, i64> min_cost_max_flow(
+    FlowNetwork &network,
+    vector<i64> &edge_costs,
+    int s,
+    int t,
+    MinCostAlgorithm algorithm = MinCostAlgorithm::SUCCESSIVE_SHORTEST_PATHS
+    ) {
+  if (s == t) {
+    return {0, 0};
+  }
+  vector<i64> cost = residual_costs(network, edge_costs);
+  if (algorithm == MinCostAlgorithm::COST_SCALING) {
+    return cost_scaling(network, cost, s, t);
+  }
+  return successive_shortest_paths(network, cost, s, t);
+}
+
+int main(int argc, char *argv[]) {
+  ios::sync_with_stdio(false);
+  cin.tie(nullptr);
+  cout.tie(nullptr);
+
+  MinCostAlgorithm algorithm = MinCostAlgorithm::SUCCESSIVE_SHORTEST_PATHS;
+  if (argc > 1 && strcmp(argv[1], "--cost-scaling") == 0) {
+    algorithm = MinCostAlgorithm::COST_SCALING;
+  }
+
+  int nodes, edges, source, sink, u, v;
+  i64 c, w;
+  while (true) {
+    cin >> nodes >> edges >> source >> sink;
+    if (cin.eof()) {
+      break;
+    }
+
+    // Read the edges of the network and construct its residual graph
+    // Memory consumption O(|V|+|E|)
+    vector<tuple<int, int, i64>> edge_list;
+    vector<i64> edge_costs;
+    edge_list.reserve(edges);
+    edge_costs.reserve(edges);
+    for (int e = 0; e < edges; e++) {
+      cin >> u >> v >> c >> w;
+      edge_list.push_back({u, v, c});
+      edge_costs.push_back(w);
+    }
+    FlowNetwork network = FlowNetwork(nodes, edge_list);
+
+    pair<i64, i64> result = min_cost_max_flow(network, edge_costs, source, sink, algorithm);
+    cout << result.first << " " << result.second << "\n";
+  }
+  cout.flush();
+}
@@ -0,0 +1,177 @@
+/**
+ * Johannes Kung johku144
+ *
+ * Directed or undirected multigraph in Compressed Sparse Row (CSR) format for
+ * finding Eulerian paths, together with the checks for whether one exists.
+ *
+ * The arcs of a directed graph are stored reversed, i.e. an edge u->v is
+ * stored as an arc v->u among the arcs leaving v. Hierholzer's algorithm
+ * outputs the nodes of a path in reverse order, so running it on the reversed
+ * graph from the end of the path outputs the path from its start, without
+ * keeping a copy to reverse. An undirected edge u-v is stored as the two
+ * arcs u->v and v->u. Every arc knows the index of its edge, which is shared
+ * by the two arcs of an undirected edge.
+ *
+ * Memory consumption: O(|V|+|E|)
+ */
+#pragma once
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+using namespace std;
+using i64 = int64_t;
+
+struct EulerGraph {
+  int nodes;
+  int edges;
+  bool directed;
+
+  // The arcs leaving node u are those with indices first_arc[u], ...,
+  // first_arc[u+1]-1. An undirected graph has 2*|E| arcs, which may not fit
+  // in an int
+  vector<i64> first_arc;
+
+  // For every arc: the node it points to and the index of its edge
+  vector<int> head;
+  vector<int> edge_of;
+
+  // In and out degree of every node in the graph as given. For undirected
+  // graphs both are the degree
+  vector<int> deg_in;
+  vector<int> deg_out;
+
+  /**
+   * Constructs the graph from a list of edges (u, v).
+   *
+   * Time complexity: O(|V|+|E|) using a counting sort on the tail of every arc
+   */
+  EulerGraph(int nodes, vector<pair<int, int>> &edge_list, bool directed)
+    : nodes(nodes), edges(edge_list.size()), directed(directed) {
+    deg_in = vector<int>(nodes, 0);
+    deg_out = vector<int>(nodes, 0);
+    for (pair<int, int> &e : edge_list) {
+      deg_out[e.first]++;
+      deg_in[e.second]++;
+      if (!directed) {
+        deg_out[e.second]++;
+        deg_in[e.first]++;
+      }
+    }
+
+    // Directed graphs are stored reversed, so the arcs leaving u are its
+    // incoming edges
+    first_arc = vector<i64>(nodes + 1, 0);
+    for (int u = 0; u < nodes; u++) {
+      first_arc[u + 1] = first_arc[u] + (directed ? deg_in[u] : deg_out[u]);
+    }
+
+    head = vector<int>(first_arc[nodes]);
+    edge_of = vector<int>(first_arc[nodes]);
+    vector<i64> next = vector<i64>(first_arc.begin(), first_arc.end() - 1);
+    for (int i = 0; i < edges; i++) {
+      int u = edge_list[i].first;
+      int v = edge_list[i].second;
+      if (directed) {
+        edge_of[next[v]] = i;
+        head[next[v]++] = u;
+      }
+      else {
+        edge_of[next[u]] = i;
+        head[next[u]++] = v;
+        edge_of[next[v]] = i;
+        head[next[v]++] = u;
+      }
+    }
+  }
+
+  /**
+   * Checks the degree requirements for an Eulerian path and returns the
+   * nodes the path starts and ends in, or (-1, -1) if the degrees rule out a
+   * path.
+   *
+   *  - Directed: all nodes have in degree == out degree, except at most one
+   *    start node with out degree == in degree+1 and one end node with in
+   *    degree == out degree+1.
+   *  - Undirected: zero or two nodes have an odd degree, which are then the
+   *    ends of the path.
+   *
+   * If the path is a cycle it starts and ends in node 0, or in the first node
+   * with an edge if node 0 has none. For undirected graphs the ends are
+   * interchangeable.
+   *
+   * Time complexity: O(|V|)
+   */
+  pair<int, int> path_ends() {
+    int start = -1;
+    int end = -1;
+    int first_used = -1;
+    for (int u = 0; u < nodes; u++) {
+      if (first_used == -1 && deg_out[u] > 0) {
+        first_used = u;
+      }
+      if (directed) {
+        if (deg_out[u] == deg_in[u] + 1 && start == -1) {
+          start = u;
+        }
+        else if (deg_in[u] == deg_out[u] + 1 && end == -1) {
+          end = u;
+        }
+        else if (deg_in[u] != deg_out[u]) {
+          return {-1, -1};
+        }
+      }
+      else if (deg_out[u] % 2 == 1) {
+        if (start == -1) {
+          start = u;
+        }
+        else if (end == -1) {
+          end = u;
+        }
+        else {
+          return {-1, -1};
+        }
+      }
+    }
+
+    if (end != -1) {
+      return {start, end};
+    }
+    if (deg_out[0] > 0 || first_used == -1) {
+      return {0, 0};
+    }
+    return {first_used, first_used};
+  }
+
+  /**
+   * Checks that every arc can be reached from the given node, which is
+   * required for an Eulerian path from it. Together with the degree
+   * requirements this is also sufficient, so a path can be output while it
+   * is being found.
+   *
+   * Time complexity: O(|V|+|E|) for a DFS over the arcs
+   */
+  bool all_arcs_reachable(int from) {
+    vector<char> visited = vector<char>(nodes, 0);
+    vector<int> stack = {from};
+    visited[from] = 1;
+    while (!stack.empty()) {
+      int u = stack.back();
+      stack.pop_back();
+      for (i64 a = first_arc[u]; a < first_arc[u + 1]; a++) {
+        int v = head[a];
+        if (!visited[v]) {
+          visited[v] = 1;
+          stack.push_back(v);
+        }
+      }
+    }
+
+    for (int u = 0; u < nodes; u++) {
+      if (deg_in[u] + deg_out[u] > 0 && !visited[u]) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
@@ -1,154 +1,139 @@
 /**
  * Johannes Kung johku144
  *
- * Finding an eulerian path in a directed graph.
+ * Finding an eulerian path in a directed or undirected multigraph, optionally
+ * with a parallel algorithm for directed graphs.
  *
- * Time complexity: O(|E|), see eulerian_path()
+ * Usage: euler_path [--undirected] [--parallel [threads]] < input
+ *
+ * Time complexity: O(|V|+|E|), see eulerian_path() and parallel_euler_tour.h
+ * Memory consumption: O(|V|+|E|)
+ *  - Graph in CSR format O(|V|+|E|) (see euler_graph.h)
+ *  - Edge cursors O(|V|), DFS stack O(|E|)
  */
-#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <ios>
+#include <utility>
 #include <vector>
-#include <deque>
+#include "euler_graph.h"
+#include "parallel_euler_tour.h"
 
 using namespace std;
-using Adj_list = vector<vector<int>>;
 
 /**
- * Finds and returns a Eulerian path in a given graph if there is one. This 
- * path will actually be a Eulerian cycle if there is one in the graph.
+ * Finds a Eulerian path in a given graph if there is one and writes its nodes
+ * to out, separated by spaces and ended by a newline. This path will actually
+ * be a Eulerian cycle if there is one in the graph. The graph is not
+ * modified, so it can be searched again.
+ *
+ * Both requirements for the existence of a path, the degrees and that all
+ * edges are reachable, are checked before anything is written. The path is
+ * then found with Hierholzer's algorithm, which traverses every edge exactly
+ * once. Walking from a node along unused edges can only get stuck in the node
+ * the walk started from (or the end of the path), which closes a cycle. The
+ * walk then backtracks along the DFS stack until it reaches a node with
+ * unused edges, where the next cycle starts. Nodes are output as they are
+ * popped from the stack, which is the path backwards. As the graph is stored
+ * with reversed arcs (see euler_graph.h), starting from the end of the path
+ * outputs it forwards.
  *
- * Input: an adjacency list for the graph and the number of edges
- * Output: a vector of node indices representing the Eulerian path/cycle,
- *         empty list of there is no such path/cycle
+ * Every node has a cursor to its next unused arc, so no edge is looked at
+ * more than twice. Undirected edges are marked as used so that the other arc
+ * of the same edge is skipped.
  *
- * Time complexity: O(|E|)
+ * Input: the graph and the stream to write the path to
+ * Output: true if there is a Eulerian path, otherwise nothing is written
+ *
+ * Time complexity: O(|V|+|E|)
  */
-vector<int> eulerian_path(Adj_list &adj_list, int edges) {
-  // Calculate the in and out degrees of every node
-  // O(|E|)
-  vector<int> deg_in = vector<int>(adj_list.size());
-  vector<int> deg_out = vector<int>(adj_list.size());
-  for (int u = 0; u < adj_list.size(); ++u) {
-    deg_out[u] = adj_list[u].size();
-    for (int v : adj_list[u]) {
-      deg_in[v]++;
-    }
+bool eulerian_path(EulerGraph &graph, ostream &out) {
+  // Hierholzer's algorithm on the stored arcs starts where the path ends
+  int start = graph.path_ends().second;
+  if (start == -1 || !graph.all_arcs_reachable(start)) {
+    return false;
   }
 
-  // Check the requirements for the existence of an eulerian path in the graph:
-  // (This must hold for the existance but does not guarantee it)
-  //
-  // There should be at most one node with indegree + 1 == outdegree 
-  // and at most one with outdegree + 1 == indegree for the graph to contain
-  // an eulerian path. Save the indices of these two nodes
-  //
-  // Also all other nodes should have indegree == outdegree
-  //
-  // O(|V|)
-  int an = -1;
-  int bn = -1;
-  for (int n = 0; n < deg_in.size(); ++n) {
-    if (deg_in[n] + 1 == deg_out[n]) {
-      if (an == -1) {
-        an = n;
-      }
-      else {
-        return {};
-      }
-    }
-    else if (deg_out[n] + 1 == deg_in[n]) {
-      if (bn == -1) {
-        bn = n;
-      }
-      else {
-        return {};
-      }
-    }
-    else if (deg_in[n] != deg_out[n]) {
-      return {};
-    }
+  vector<i64> cursor = vector<i64>(graph.first_arc.begin(), graph.first_arc.end() - 1);
+  vector<char> used;
+  if (!graph.directed) {
+    used = vector<char>(graph.edges, 0);
   }
 
-
-  // Try to find an eulerian path by traversing every edge on all the paths 
-  // from the starting node exactly once .This basically finds all simple cycles
-  // (and perhaps also a path) and joins them into a big cycle (path)
-  // This is sort of similar to Hierholzer's algorithm
-  //
-  // If there is a node with outdegree = indegree + 1, a.k.a. the node 'an',
-  // then the path needs to start from this node and take the outgoing edge 
-  // so that the the remaining edges of 'an' make for an indegree equal to the 
-  // outdegree. There will not be any other way to traverse all edges of 'an' 
-  // as we enter and leave any node an equal amount of times
-  //
-  // If there is no such node then it will be that all nodes have indegree == outdegree 
-  // so we can start from any node (assuming there is an eulerian path)
-  //
-  // O(|E|) as a node is pushed for every edge incident with the node
-  vector<int> cycle;
-  deque<int> stack = {max(0, an)};
+  vector<int> stack = {start};
+  bool first = true;
   while (!stack.empty()) {
     int node = stack.back();
+    i64 &a = cursor[node];
+    if (!graph.directed) {
+      while (a < graph.first_arc[node + 1] && used[graph.edge_of[a]]) {
+        a++;
+      }
+    }
 
-    if (adj_list[node].empty()) {
-      // The end of a simple cycle (or the single path in the graph) has been reached
-      // Add this cycle to the the eulerian path and backtrack
-      cycle.push_back(node);
+    if (a == graph.first_arc[node + 1]) {
+      // No unused edges left: the node is the next one on the path
+      if (!first) {
+        out << " ";
+      }
+      out << node;
+      first = false;
       stack.pop_back();
     }
     else {
-      int i = adj_list[node].size() - 1;
-      stack.push_back(adj_list[node][i]);
-      adj_list[node].pop_back();
+      if (!graph.directed) {
+        used[graph.edge_of[a]] = 1;
+      }
+      stack.push_back(graph.head[a]);
+      a++;
     }
   }
-
-  reverse(cycle.begin(), cycle.end());
-
-  // If the found cycle is an eulerian cycle, then all edges of the graph must
-  // have been used
-  // If less edges have been used then there is no eulerian cycle
-  if (cycle.size() < edges+1) {
-    return {};
-  }
-
-  return cycle;
+  out << "\n";
+  return true;
 }
 
-int main() {
+int main(int argc, char *argv[]) {
   ios::sync_with_stdio(false);
   cin.tie(nullptr);
   cout.tie(nullptr);
-  int nodes, edges, u, v;
 
+  bool directed = true;
+  int threads = 0;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--undirected") == 0) {
+      directed = false;
+    }
+    else if (strcmp(argv[i], "--parallel") == 0) {
+      threads = max(1u, thread::hardware_concurrency());
+      if (i + 1 < argc && atoi(argv[i + 1]) > 0) {
+        threads = atoi(argv[++i]);
+      }
+    }
+  }
+
+  int nodes, edges, u, v;
   while (true) {
     cin >> nodes >> edges;
     if (cin.eof() || (nodes == 0 && edges == 0)) {
       break;
     }
 
-    Adj_list adj_list = Adj_list(nodes);
+    vector<pair<int, int>> edge_list;
+    edge_list.reserve(edges);
     for (int e  = 0; e < edges; ++e) {
       cin >> u >> v;
-      adj_list[u].push_back(v);
+      edge_list.push_back({u, v});
     }
+    EulerGraph graph = EulerGraph(nodes, edge_list, directed);
 
-    vector<int> path = eulerian_path(adj_list, edges);
-    if (path.empty()) {
+    // The parallel algorithm only handles directed graphs
+    bool found = directed && threads > 0
+      ? parallel_eulerian_path(graph, cout, threads)
+      : eulerian_path(graph, cout);
+    if (!found) {
       cout << "Impossible\n";
     }
-    else {
-      for (int i = 0; i < path.size(); ++i) {
-        cout << path[i];
-        if (i < path.size() - 1) {
-          cout << " ";
-        }
-        else {
-          cout << "\n";
-        }
-      }
-    }
   }
 
   cout.flush();
@@ -0,0 +1,305 @@
+/**
+ * Johannes Kung johku144
+ *
+ * Eulerian path in a directed multigraph using a parallel cycle splicing
+ * algorithm, for graphs with too many edges for a sequential Hierholzer.
+ *
+ *  1. A path is turned into a cycle by adding a dummy edge from its end to its
+ *     start.
+ *  2. Every node pairs its i-th incoming edge with its i-th outgoing edge,
+ *     which gives a successor for every edge. As every node has as many
+ *     incoming as outgoing edges, the successors form a permutation of the
+ *     edges, which splits them into edge disjoint cycles. This is done in
+ *     parallel over the nodes.
+ *  3. The cycles are labelled in parallel by walking along the successors.
+ *  4. Cycles are spliced together at the nodes they share. Swapping the
+ *     successors of two incoming edges of the same node that lie on different
+ *     cycles merges the two cycles into one. Which cycles have been merged is
+ *     kept track of with Union-Find. Finding the swaps is done in parallel,
+ *     only the swaps themselves are done sequentially.
+ *  5. If all edges end up on one cycle, following the successors from the
+ *     dummy edge gives the path.
+ *
+ * Time complexity: O(|V|+|E|) work, O((|V|+|E|)/threads + C) span where C is
+ *                  the number of cycles in step 2, plus O(|E|) to output
+ * Memory consumption: O(|V|+|E|) on top of the graph
+ */
+#pragma once
+#include <atomic>
+#include <functional>
+#include <iostream>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "euler_graph.h"
+
+using namespace std;
+
+/**
+ * Union-Find over cycle labels, with union by size and path halving so that
+ * find() needs no recursion.
+ */
+struct CycleUnion {
+  vector<int> parent;
+  vector<int> size;
+
+  CycleUnion(int n) : parent(n), size(n, 1) {
+    for (int i = 0; i < n; i++) {
+      parent[i] = i;
+    }
+  }
+
+  int find(int a) {
+    while (parent[a] != a) {
+      parent[a] = parent[parent[a]];
+      a = parent[a];
+    }
+    return a;
+  }
+
+  /**
+   * Output: true if a and b were in different sets
+   */
+  bool join(int a, int b) {
+    a = find(a);
+    b = find(b);
+    if (a == b) {
+      return false;
+    }
+    if (size[a] < size[b]) {
+      swap(a, b);
+    }
+    parent[b] = a;
+    size[a] += size[b];
+    return true;
+  }
+};
+
+struct ParallelEulerTour {
+  EulerGraph &graph;
+  int threads;
+  int n;
+
+  // The dummy edge has index m, and only exists if the path is not a cycle
+  int m;
+  int start;
+  int end;
+  bool has_dummy;
+
+  // Outgoing edges of every node in CSR format, including the dummy edge
+  vector<i64> first_out;
+  vector<int> out_edges;
+
+  // The successor of every edge on its cycle, and the node it points to
+  vector<int> successor;
+  vector<int> edge_head;
+
+  // The label of the cycle of every edge, which is the index of the edge its
+  // labelling walk started from
+  vector<atomic<int>> label;
+
+  // Per thread: pairs of labels on the same cycle found while labelling, and
+  // pairs of incoming edges of the same node on different cycles
+  vector<vector<pair<int, int>>> same_cycle;
+  vector<vector<pair<int, int>>> splices;
+
+  ParallelEulerTour(EulerGraph &graph, int threads, int start, int end)
+    : graph(graph),
+      threads(threads),
+      n(graph.nodes),
+      m(graph.edges),
+      start(start),
+      end(end),
+      has_dummy(start != end),
+      successor(m + 1),
+      edge_head(m + 1),
+      label(m + 1),
+      same_cycle(threads),
+      splices(threads) {}
+
+  /**
+   * Runs f(tid) for every thread id and waits for all of them.
+   */
+  void in_parallel(function<void(int)> f) {
+    vector<thread> workers;
+    for (int tid = 1; tid < threads; tid++) {
+      workers.push_back(thread(f, tid));
+    }
+    f(0);
+    for (thread &worker : workers) {
+      worker.join();
+    }
+  }
+
+  i64 chunk_begin(int tid, i64 size) {
+    return size * tid / threads;
+  }
+
+  int in_degree(int v) {
+    return graph.first_arc[v + 1] - graph.first_arc[v] + (has_dummy && v == start);
+  }
+
+  /**
+   * The i-th incoming edge of v. The arcs of a directed graph are stored
+   * reversed, so these are the arcs leaving v, followed by the dummy edge.
+   */
+  int in_edge(int v, int i) {
+    i64 a = graph.first_arc[v] + i;
+    return a < graph.first_arc[v + 1] ? graph.edge_of[a] : m;
+  }
+
+  /**
+   * Builds the lists of outgoing edges with a counting sort on the tails.
+   *
+   * Time complexity: O(|V|+|E|)
+   */
+  void build_out_edges() {
+    first_out = vector<i64>(n + 1, 0);
+    for (int u = 0; u < n; u++) {
+      first_out[u + 1] = first_out[u] + graph.deg_out[u] + (has_dummy && u == end);
+    }
+    out_edges = vector<int>(first_out[n]);
+    vector<i64> next = vector<i64>(first_out.begin(), first_out.end() - 1);
+    for (int v = 0; v < n; v++) {
+      for (i64 a = graph.first_arc[v]; a < graph.first_arc[v + 1]; a++) {
+        out_edges[next[graph.head[a]]++] = graph.edge_of[a];
+      }
+    }
+    if (has_dummy) {
+      out_edges[next[end]++] = m;
+    }
+  }
+
+  /**
+   * Step 2, for the nodes of one thread: pairs up incoming and outgoing edges.
+   */
+  void pair_edges(int tid) {
+    for (int v = chunk_begin(tid, n); v < chunk_begin(tid + 1, n); v++) {
+      for (int i = 0; i < in_degree(v); i++) {
+        int e = in_edge(v, i);
+        successor[e] = out_edges[first_out[v] + i];
+        edge_head[e] = v;
+        label[e].store(-1, memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * Step 3, for the edges of one thread: every edge that has no label yet
+   * starts a walk along the successors that labels the edges it passes. A
+   * walk stops when it gets back to its first edge or reaches an edge labelled
+   * by another walk on the same cycle, in which case the two labels are
+   * recorded as belonging to the same cycle.
+   */
+  void label_cycles(int tid) {
+    int edges = m + has_dummy;
+    for (int e = chunk_begin(tid, edges); e < chunk_begin(tid + 1, edges); e++) {
+      int unlabelled = -1;
+      if (!label[e].compare_exchange_strong(unlabelled, e)) {
+        continue;
+      }
+      for (int x = successor[e]; x != e; x = successor[x]) {
+        unlabelled = -1;
+        if (!label[x].compare_exchange_strong(unlabelled, e)) {
+          same_cycle[tid].push_back({e, unlabelled});
+          break;
+        }
+      }
+    }
+  }
+
+  /**
+   * Step 4, for the nodes of one thread: finds incoming edges on other cycles
+   * than the first incoming edge of the node. Consecutive edges with the same
+   * label are skipped, as they end up in the same set once the first is
+   * spliced.
+   */
+  void find_splices(int tid) {
+    for (int v = chunk_begin(tid, n); v < chunk_begin(tid + 1, n); v++) {
+      int degree = in_degree(v);
+      if (degree == 0) {
+        continue;
+      }
+      int first = in_edge(v, 0);
+      int first_label = label[first].load(memory_order_relaxed);
+      int previous_label = first_label;
+      for (int i = 1; i < degree; i++) {
+        int e = in_edge(v, i);
+        int l = label[e].load(memory_order_relaxed);
+        if (l != first_label && l != previous_label) {
+          splices[tid].push_back({first, e});
+        }
+        previous_label = l;
+      }
+    }
+  }
+
+  /**
+   * Finds the path and writes it to out.
+   *
+   * Output: true if the path was written, false if the edges could not be
+   *         spliced into a single cycle, i.e. the graph is not connected
+   */
+  bool run(ostream &out) {
+    build_out_edges();
+    in_parallel([&](int tid) { pair_edges(tid); });
+    in_parallel([&](int tid) { label_cycles(tid); });
+    in_parallel([&](int tid) { find_splices(tid); });
+
+    // Merge the labels of the same cycle and count the cycles
+    int edges = m + has_dummy;
+    CycleUnion cycles = CycleUnion(edges);
+    int cycle_count = 0;
+    for (int e = 0; e < edges; e++) {
+      if (label[e].load(memory_order_relaxed) == e) {
+        cycle_count++;
+      }
+    }
+    for (vector<pair<int, int>> &pairs : same_cycle) {
+      for (pair<int, int> &p : pairs) {
+        if (cycles.join(p.first, p.second)) {
+          cycle_count--;
+        }
+      }
+    }
+
+    for (vector<pair<int, int>> &pairs : splices) {
+      for (pair<int, int> &p : pairs) {
+        if (cycles.join(label[p.first].load(), label[p.second].load())) {
+          swap(successor[p.first], successor[p.second]);
+          cycle_count--;
+        }
+      }
+    }
+    if (cycle_count > 1) {
+      return false;
+    }
+
+    // Follow the successors from the start of the path. A cycle starts with
+    // the first outgoing edge of its start node
+    out << start;
+    int e = has_dummy ? successor[m] : (m > 0 ? out_edges[first_out[start]] : -1);
+    for (int i = 0; i < m; i++) {
+      out << " " << edge_head[e];
+      e = successor[e];
+    }
+    out << "\n";
+    return true;
+  }
+};
+
+/**
+ * Finds a Eulerian path in a given directed graph if there is one and writes
+ * it to out, in the same format as eulerian_path(). The graph is not modified.
+ *
+ * Input: the graph, the stream to write the path to and the number of threads
+ * Output: true if there is a Eulerian path, otherwise nothing is written
+ */
+bool parallel_eulerian_path(EulerGraph &graph, ostream &out, int threads) {
+  pair<int, int> ends = graph.path_ends();
+  if (ends.first == -1) {
+    return false;
+  }
+  ParallelEulerTour tour = ParallelEulerTour(graph, threads, ends.first, ends.second);
+  return tour.run(out);
+}
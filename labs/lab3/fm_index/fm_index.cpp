@@ -0,0 +1,112 @@
+/**
+ * Johannes Kung johku144
+ *
+ * Counting and locating the occurrences of patterns in a text using an
+ * FM-index, which takes a fraction of the memory of a suffix array.
+ *
+ * Usage: fm_index [sample_rate] [--count] [--save file | --load file] < input
+ * Input: a line with the text, the number of patterns q and q lines with a
+ *        pattern each, repeated until the end of the input
+ * Output: for every pattern, the number of occurrences followed by their
+ *         start positions in the text, unless --count is given
+ *
+ * With --save, the whole input is the text and its index is written to the
+ * file. With --load, the index is read from the file and every line of the
+ * input is a pattern.
+ *
+ * Time complexity: O(n*log(sigma)) construction, see fm_index.h for queries
+ */
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <ios>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "fm_index.h"
+
+using namespace std;
+
+/**
+ * Writes the answer for a pattern, see the usage above.
+ */
+void answer(const FMIndex &index, const string &pattern, bool count_only) {
+  if (count_only) {
+    cout << index.count(pattern) << "\n";
+    return;
+  }
+
+  vector<i64> positions = index.locate(pattern);
+  cout << positions.size();
+  for (i64 p : positions) {
+    cout << " " << p;
+  }
+  cout << "\n";
+}
+
+int main(int argc, char *argv[]) {
+  ios::sync_with_stdio(false);
+  cin.tie(nullptr);
+  cout.tie(nullptr);
+
+  int sample_rate = 32;
+  bool count_only = false;
+  const char *save_path = nullptr;
+  const char *load_path = nullptr;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--count") == 0) {
+      count_only = true;
+    }
+    else if (strcmp(argv[i], "--save") == 0 && i + 1 < argc) {
+      save_path = argv[++i];
+    }
+    else if (strcmp(argv[i], "--load") == 0 && i + 1 < argc) {
+      load_path = argv[++i];
+    }
+    else {
+      sample_rate = max(1, atoi(argv[i]));
+    }
+  }
+
+  if (save_path != nullptr) {
+    string text = string(istreambuf_iterator<char>(cin), istreambuf_iterator<char>());
+    FMIndex index = FMIndex(text, sample_rate);
+    if (!index.save(save_path)) {
+      perror(save_path);
+      return 1;
+    }
+    return 0;
+  }
+
+  string text, pattern;
+  if (load_path != nullptr) {
+    FMIndex index;
+    if (!FMIndex::load(load_path, index)) {
+      if (errno == 0) {
+        errno = EINVAL;
+      }
+      perror(load_path);
+      return 1;
+    }
+    while (getline(cin, pattern)) {
+      answer(index, pattern, count_only);
+    }
+    cout.flush();
+    return 0;
+  }
+
+  int q;
+  while (getline(cin, text) && cin >> q) {
+    cin.ignore();
+    FMIndex index = FMIndex(text, sample_rate);
+    for (int i = 0; i < q; i++) {
+      getline(cin, pattern);
+      answer(index, pattern, count_only);
+    }
+  }
+
+  cout.flush();
+}
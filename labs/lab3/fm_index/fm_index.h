@@ -0,0 +1,737 @@
+/**
+ * Johannes Kung johku144
+ *
+ * The FM-index: a compressed full-text index that counts and locates the
+ * occurrences of a pattern in a text without keeping the text or its suffix
+ * array in memory.
+ *
+ * The index stores the Burrows-Wheeler transform (BWT) of the text in a
+ * wavelet matrix, which answers how often a character occurs in a prefix of
+ * the BWT, and the suffix array only at every sample_rate-th text position.
+ * Counting is a backward search over the pattern, locating walks from every
+ * match to the closest sampled position before it.
+ *
+ * Time complexity:
+ *  - Construction: O(n*log(sigma)) after the suffix array, see sa_is()
+ *  - count(): O(|P|*log(sigma))
+ *  - locate(): O((|P| + occurrences*sample_rate)*log(sigma))
+ * Memory consumption: about n*(ceil(log2(sigma)) + 1)*(1 + 1/16) bits for the
+ * BWT and the sample marks plus 8*n/sample_rate bytes for the samples, where
+ * sigma is the number of distinct characters in the text. The construction
+ * needs the suffix array of the text, 4 bytes per character below 2^31
+ * characters and 8 above, which is freed before it returns. save() and
+ * load() let the index be built on a machine with room for it and used on
+ * one without.
+ */
+#pragma once
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+using i64 = int64_t;
+using u64 = uint64_t;
+using u32 = uint32_t;
+
+/**
+ * Sorts the suffixes of s[0...n-1] using SA-IS (induced sorting) by Nong, Zhang
+ * and Chan, as in labs/lab3/task3, with suffix array entries of type Index.
+ * All characters must be in 0...upper.
+ *
+ * Every suffix is S-type if it is smaller than the suffix after it and L-type
+ * otherwise, and an S-type suffix after an L-type one is a leftmost S-type
+ * (LMS) suffix. If the LMS suffixes are sorted, one left-to-right pass puts
+ * the L-type suffixes in place and one right-to-left pass the S-type ones,
+ * as every suffix is ordered by its first character and then the suffix
+ * after it (induced sorting). The LMS suffixes are sorted by first inducing
+ * from them in text order, which sorts the substrings between consecutive
+ * LMS positions. Naming those substrings gives a string of at most n/2
+ * characters, whose suffix array is found recursively and gives the order of
+ * the LMS suffixes.
+ *
+ * Time complexity: O(n + upper)
+ */
+template <typename Index, typename Char>
+vector<Index> sa_is(const Char *s, i64 n, i64 upper) {
+  if (n == 0) {
+    return {};
+  }
+  if (n == 1) {
+    return {0};
+  }
+  if (n == 2) {
+    if (s[0] < s[1]) {
+      return {0, 1};
+    }
+    return {1, 0};
+  }
+
+  vector<Index> sa(n);
+  vector<bool> is_s(n, false);
+  for (i64 i = n - 2; i >= 0; i--) {
+    is_s[i] = s[i] == s[i + 1] ? is_s[i + 1] : s[i] < s[i + 1];
+  }
+
+  // Start of the L-type and S-type parts of the bucket of every character
+  vector<Index> start_l(upper + 1, 0), start_s(upper + 1, 0);
+  for (i64 i = 0; i < n; i++) {
+    if (!is_s[i]) {
+      start_s[s[i]]++;
+    }
+    else {
+      start_l[s[i] + 1]++;
+    }
+  }
+  for (i64 c = 0; c <= upper; c++) {
+    start_s[c] += start_l[c];
+    if (c < upper) {
+      start_l[c + 1] += start_s[c];
+    }
+  }
+
+  vector<Index> bucket(upper + 1);
+  auto induce = [&](const vector<Index> &lms) {
+    fill(sa.begin(), sa.end(), -1);
+    copy(start_s.begin(), start_s.end(), bucket.begin());
+    for (i64 d : lms) {
+      if (d != n) {
+        sa[bucket[s[d]]++] = d;
+      }
+    }
+    copy(start_l.begin(), start_l.end(), bucket.begin());
+    sa[bucket[s[n - 1]]++] = n - 1;
+    for (i64 i = 0; i < n; i++) {
+      i64 v = sa[i];
+      if (v >= 1 && !is_s[v - 1]) {
+        sa[bucket[s[v - 1]]++] = v - 1;
+      }
+    }
+    copy(start_l.begin(), start_l.end(), bucket.begin());
+    for (i64 i = n - 1; i >= 0; i--) {
+      i64 v = sa[i];
+      if (v >= 1 && is_s[v - 1]) {
+        sa[--bucket[s[v - 1] + 1]] = v - 1;
+      }
+    }
+  };
+
+  // The index of every LMS position among the LMS positions, -1 otherwise
+  vector<Index> lms_index(n + 1, -1);
+  vector<Index> lms;
+  for (i64 i = 1; i < n; i++) {
+    if (!is_s[i - 1] && is_s[i]) {
+      lms_index[i] = lms.size();
+      lms.push_back(i);
+    }
+  }
+  i64 m = lms.size();
+
+  induce(lms);
+  if (m > 0) {
+    vector<Index> sorted_lms;
+    sorted_lms.reserve(m);
+    for (i64 v : sa) {
+      if (lms_index[v] != -1) {
+        sorted_lms.push_back(v);
+      }
+    }
+
+    // Name the LMS substrings in sorted order, equal substrings get the
+    // same name
+    vector<Index> reduced(m);
+    i64 names = 0;
+    reduced[lms_index[sorted_lms[0]]] = 0;
+    for (i64 i = 1; i < m; i++) {
+      i64 l = sorted_lms[i - 1];
+      i64 r = sorted_lms[i];
+      i64 end_l = lms_index[l] + 1 < m ? (i64) lms[lms_index[l] + 1] : n;
+      i64 end_r = lms_index[r] + 1 < m ? (i64) lms[lms_index[r] + 1] : n;
+      bool same = true;
+      if (end_l - l != end_r - r) {
+        same = false;
+      }
+      else {
+        while (l < end_l && s[l] == s[r]) {
+          l++;
+          r++;
+        }
+        if (l == n || s[l] != s[r]) {
+          same = false;
+        }
+      }
+      if (!same) {
+        names++;
+      }
+      reduced[lms_index[sorted_lms[i]]] = names;
+    }
+
+    vector<Index> reduced_sa = sa_is<Index>(reduced.data(), m, names);
+    for (i64 i = 0; i < m; i++) {
+      sorted_lms[i] = lms[reduced_sa[i]];
+    }
+    induce(sorted_lms);
+  }
+  return sa;
+}
+
+/**
+ * Writes the size of a vector followed by its entries to a binary stream.
+ */
+template <typename T>
+void write_vector(ostream &out, const vector<T> &v) {
+  u64 size = v.size();
+  out.write((const char *) &size, sizeof(size));
+  out.write((const char *) v.data(), size * sizeof(T));
+}
+
+/**
+ * Reads a vector written by write_vector(). remaining is the number of bytes
+ * left in the stream, so that a corrupt size does not allocate more than the
+ * file holds.
+ *
+ * Output: true on success
+ */
+template <typename T>
+bool read_vector(istream &in, vector<T> &v, u64 &remaining) {
+  u64 size;
+  if (remaining < sizeof(size) || !in.read((char *) &size, sizeof(size))) {
+    return false;
+  }
+  remaining -= sizeof(size);
+  if (size > remaining / sizeof(T)) {
+    return false;
+  }
+  v = vector<T>(size);
+  remaining -= size * sizeof(T);
+  return (bool) in.read((char *) v.data(), size * sizeof(T));
+}
+
+/**
+ * A bit vector that counts the set bits before any position in O(1).
+ *
+ * The number of set bits before every block of 8 words is stored relative to
+ * its superblock of 2^31 bits, so that it fits in 32 bits, and the words of
+ * the block before the position are counted with popcount. This adds 32 bits
+ * per 512 bits, plus 64 bits per superblock.
+ */
+struct RankBitvector {
+  static const int BLOCK_WORDS = 8;
+  static const i64 SUPERBLOCK_WORDS = ((i64) 1 << 31) / 64;
+  vector<u64> words;
+  vector<u32> block_rank;
+  vector<u64> superblock_rank;
+
+  RankBitvector(i64 n = 0) : words(n / 64 + 1, 0) {}
+
+  void set(i64 i) {
+    words[i / 64] |= (u64) 1 << (i % 64);
+  }
+
+  bool get(i64 i) const {
+    return (words[i / 64] >> (i % 64)) & 1;
+  }
+
+  /**
+   * Must be called after the last set() and before the first rank1().
+   */
+  void build_ranks() {
+    block_rank = vector<u32>(words.size() / BLOCK_WORDS + 1, 0);
+    superblock_rank.clear();
+    u64 ones = 0;
+    for (i64 w = 0; w < (i64) words.size(); w++) {
+      if (w % SUPERBLOCK_WORDS == 0) {
+        superblock_rank.push_back(ones);
+      }
+      if (w % BLOCK_WORDS == 0) {
+        block_rank[w / BLOCK_WORDS] = ones - superblock_rank.back();
+      }
+      ones += __builtin_popcountll(words[w]);
+    }
+  }
+
+  /**
+   * Output: the number of set bits in positions 0, ..., i-1
+   */
+  i64 rank1(i64 i) const {
+    i64 w = i / 64;
+    i64 ones = superblock_rank[w / SUPERBLOCK_WORDS] + block_rank[w / BLOCK_WORDS];
+    for (i64 b = w - w % BLOCK_WORDS; b < w; b++) {
+      ones += __builtin_popcountll(words[b]);
+    }
+    if (i % 64 != 0) {
+      ones += __builtin_popcountll(words[w] & (((u64) 1 << (i % 64)) - 1));
+    }
+    return ones;
+  }
+
+  i64 rank0(i64 i) const {
+    return i - rank1(i);
+  }
+
+  size_t memory_bytes() const {
+    return words.size() * sizeof(u64) + block_rank.size() * sizeof(u32)
+      + superblock_rank.size() * sizeof(u64);
+  }
+
+  void save(ostream &out) const {
+    write_vector(out, words);
+    write_vector(out, block_rank);
+    write_vector(out, superblock_rank);
+  }
+
+  /**
+   * Reads a bit vector of n bits written by save().
+   *
+   * Output: true on success
+   */
+  bool load(istream &in, i64 n, u64 &remaining) {
+    i64 word_count = n / 64 + 1;
+    return read_vector(in, words, remaining) && read_vector(in, block_rank, remaining)
+      && read_vector(in, superblock_rank, remaining)
+      && (i64) words.size() == word_count
+      && (i64) block_rank.size() == word_count / BLOCK_WORDS + 1
+      && (i64) superblock_rank.size() == (word_count + SUPERBLOCK_WORDS - 1) / SUPERBLOCK_WORDS;
+  }
+};
+
+/**
+ * A wavelet matrix over a sequence of bytes: for every bit of the symbols
+ * from the highest, a bit vector holds that bit of every symbol, after which
+ * the symbols are stably partitioned on it, zeros first. All occurrences of a
+ * symbol end up next to each other after the last level, in the order they
+ * had in the sequence.
+ *
+ * Time complexity: O(log(sigma)) per query, O(n*log(sigma)) construction
+ */
+class WaveletMatrix {
+  int levels;
+  vector<RankBitvector> bits;
+  // The number of zeros in every level
+  vector<i64> zeros;
+  // Where the occurrences of every symbol start after the last level
+  vector<i64> symbol_start;
+
+public:
+  WaveletMatrix() : levels(0) {}
+
+  /**
+   * symbols are in 0, ..., sigma-1, with sigma at most 256. The vector is
+   * used as scratch space.
+   */
+  WaveletMatrix(vector<uint8_t> &symbols, int sigma) {
+    i64 n = symbols.size();
+    levels = 1;
+    while ((1 << levels) < sigma) {
+      levels++;
+    }
+
+    vector<uint8_t> next(n);
+    for (int l = 0; l < levels; l++) {
+      int shift = levels - 1 - l;
+      RankBitvector level = RankBitvector(n);
+      i64 z = 0;
+      for (i64 i = 0; i < n; i++) {
+        if ((symbols[i] >> shift) & 1) {
+          level.set(i);
+        }
+        else {
+          z++;
+        }
+      }
+      level.build_ranks();
+
+      // Stable partition on the bit, zeros first
+      i64 zero = 0, one = z;
+      for (i64 i = 0; i < n; i++) {
+        if ((symbols[i] >> shift) & 1) {
+          next[one++] = symbols[i];
+        }
+        else {
+          next[zero++] = symbols[i];
+        }
+      }
+      symbols.swap(next);
+      bits.push_back(level);
+      zeros.push_back(z);
+    }
+
+    symbol_start = vector<i64>(1 << levels, n);
+    for (i64 i = n - 1; i >= 0; i--) {
+      symbol_start[symbols[i]] = i;
+    }
+  }
+
+  /**
+   * Output: the number of occurrences of symbol c in positions 0, ..., i-1
+   */
+  i64 rank(int c, i64 i) const {
+    i64 start = 0;
+    for (int l = 0; l < levels; l++) {
+      if ((c >> (levels - 1 - l)) & 1) {
+        start = zeros[l] + bits[l].rank1(start);
+        i = zeros[l] + bits[l].rank1(i);
+      }
+      else {
+        start = bits[l].rank0(start);
+        i = bits[l].rank0(i);
+      }
+    }
+    return i - start;
+  }
+
+  /**
+   * Output: the symbol c at position i and the number of occurrences of c in
+   *         positions 0, ..., i-1, found in a single pass over the levels
+   */
+  pair<int, i64> access_rank(i64 i) const {
+    int c = 0;
+    for (int l = 0; l < levels; l++) {
+      if (bits[l].get(i)) {
+        c = (c << 1) | 1;
+        i = zeros[l] + bits[l].rank1(i);
+      }
+      else {
+        c <<= 1;
+        i = bits[l].rank0(i);
+      }
+    }
+    return {c, i - symbol_start[c]};
+  }
+
+  size_t memory_bytes() const {
+    size_t bytes = 0;
+    for (const RankBitvector &level : bits) {
+      bytes += level.memory_bytes();
+    }
+    return bytes;
+  }
+
+  void save(ostream &out) const {
+    out.write((const char *) &levels, sizeof(levels));
+    write_vector(out, zeros);
+    write_vector(out, symbol_start);
+    for (const RankBitvector &level : bits) {
+      level.save(out);
+    }
+  }
+
+  /**
+   * Reads a wavelet matrix over n symbols written by save().
+   *
+   * Output: true on success
+   */
+  bool load(istream &in, i64 n, u64 &remaining) {
+    if (remaining < sizeof(levels) || !in.read((char *) &levels, sizeof(levels))) {
+      return false;
+    }
+    remaining -= sizeof(levels);
+    if (levels < 1 || levels > 8 || !read_vector(in, zeros, remaining)
+        || !read_vector(in, symbol_start, remaining)
+        || (int) zeros.size() != levels || (int) symbol_start.size() != 1 << levels) {
+      return false;
+    }
+    bits = vector<RankBitvector>(levels);
+    for (RankBitvector &level : bits) {
+      if (!level.load(in, n, remaining)) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+/**
+ * The header of an FM-index file, followed by the arrays of the index as
+ * written by FMIndex::save(), in the byte order of the machine that wrote
+ * them, given by byte_order.
+ */
+struct FMIndexFileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order;
+  uint32_t sample_rate;
+  uint32_t sigma;
+  uint64_t n;
+  uint64_t dollar_row;
+};
+
+const char FM_INDEX_FILE_MAGIC[8] = {'F', 'M', 'I', 'N', 'D', 'E', 'X', '\0'};
+const uint32_t FM_INDEX_FILE_VERSION = 1;
+const uint32_t FM_INDEX_FILE_BYTE_ORDER = 0x01020304;
+
+/**
+ * Class for constructing the FM-index of a given string.
+ *
+ * Row r of the index is the r-th smallest suffix of text + $, where $ is a
+ * sentinel smaller than every character, so row 0 is the empty suffix at
+ * position n. The BWT holds the character before every row's suffix, with $
+ * before the suffix at position 0. That single $ is not stored in the wavelet
+ * matrix, so that up to 256 distinct characters fit in a byte; its row is
+ * skipped when counting instead.
+ *
+ * Going from a row to the row of the suffix one position earlier (the
+ * LF-mapping) is C[c] + rank(c, r), where c is the BWT character of row r and
+ * C[c] the number of characters in text + $ smaller than c. Backward search
+ * uses this for a whole range of rows at a time.
+ */
+class FMIndex {
+  i64 n = 0;
+  int sample_rate = 1;
+
+  // Characters are mapped to codes 0, ..., sigma-1 in sorted order, unused
+  // characters are -1
+  vector<int> code;
+  int sigma = 0;
+
+  // The number of characters in text + $ smaller than code c
+  vector<i64> smaller;
+  // The BWT without the $, which is in dollar_row
+  WaveletMatrix bwt;
+  i64 dollar_row = 0;
+
+  // Rows whose suffix starts at a multiple of sample_rate, and their
+  // positions in row order
+  RankBitvector sampled;
+  vector<i64> samples;
+
+  /**
+   * Output: the number of occurrences of code c in the BWT rows 0, ..., r-1
+   */
+  i64 bwt_rank(int c, i64 r) const {
+    return bwt.rank(c, r > dollar_row ? r - 1 : r);
+  }
+
+  /**
+   * Output: the rows [begin, end) whose suffixes start with the pattern,
+   *         found by backward search
+   *
+   * Time complexity: O(|P|*log(sigma))
+   */
+  pair<i64, i64> find_rows(const string &pattern) const {
+    i64 begin = 0, end = n + 1;
+    for (int i = pattern.size() - 1; i >= 0 && begin < end; i--) {
+      int c = code[(unsigned char) pattern[i]];
+      if (c == -1) {
+        return {0, 0};
+      }
+      begin = smaller[c] + bwt_rank(c, begin);
+      end = smaller[c] + bwt_rank(c, end);
+    }
+    return {begin, max(begin, end)};
+  }
+
+  /**
+   * Output: the position of the suffix of row r, found by following the
+   *         LF-mapping to a sampled row, at most sample_rate-1 steps
+   */
+  i64 row_position(i64 r) const {
+    i64 steps = 0;
+    while (!sampled.get(r)) {
+      // Position 0 is always sampled, so r is never dollar_row here
+      pair<int, i64> c = bwt.access_rank(r > dollar_row ? r - 1 : r);
+      r = smaller[c.first] + c.second;
+      steps++;
+    }
+    return samples[sampled.rank1(r)] + steps;
+  }
+
+  /**
+   * Takes the BWT and the samples from the suffix array of the text, which
+   * is freed before it returns.
+   */
+  template <typename Index>
+  void construct(const string &text, vector<uint8_t> &symbols) {
+    vector<Index> sa = sa_is<Index>((const unsigned char *) text.data(), n, 255);
+    for (i64 r = 0; r <= n; r++) {
+      i64 position = r == 0 ? n : (i64) sa[r - 1];
+      if (position == 0) {
+        dollar_row = r;
+      }
+      else {
+        symbols.push_back(code[(unsigned char) text[position - 1]]);
+      }
+      if (position % sample_rate == 0) {
+        sampled.set(r);
+        samples.push_back(position);
+      }
+    }
+  }
+
+public:
+  /**
+   * An empty index, e.g. to load() into.
+   */
+  FMIndex() {}
+
+  /**
+   * Builds the index of text, keeping the suffix array position of every
+   * sample_rate-th text position for locate(). The text is not kept.
+   *
+   * Time complexity: O(n*log(sigma)), see sa_is()
+   */
+  FMIndex(const string &text, int sample_rate = 32) : n(text.size()), sample_rate(max(1, sample_rate)) {
+    code = vector<int>(256, -1);
+    for (unsigned char c : text) {
+      code[c] = 0;
+    }
+    sigma = 0;
+    for (int c = 0; c < 256; c++) {
+      if (code[c] == 0) {
+        code[c] = sigma++;
+      }
+    }
+
+    // The BWT in row order without the $, as codes. The suffix array needs
+    // 64-bit entries for texts of 2^31 characters or more
+    vector<uint8_t> symbols;
+    symbols.reserve(n);
+    sampled = RankBitvector(n + 1);
+    if (n < numeric_limits<int>::max()) {
+      construct<int>(text, symbols);
+    }
+    else {
+      construct<i64>(text, symbols);
+    }
+    sampled.build_ranks();
+
+    smaller = vector<i64>(sigma + 1, 0);
+    smaller[0] = 1;
+    for (uint8_t c : symbols) {
+      smaller[c + 1]++;
+    }
+    for (int c = 1; c <= sigma; c++) {
+      smaller[c] += smaller[c - 1];
+    }
+    bwt = WaveletMatrix(symbols, sigma);
+  }
+
+  /**
+   * Output: the number of occurrences of the pattern in the text. The empty
+   *         pattern occurs at all n+1 positions
+   *
+   * Time complexity: O(|P|*log(sigma))
+   */
+  i64 count(const string &pattern) const {
+    pair<i64, i64> rows = find_rows(pattern);
+    return rows.second - rows.first;
+  }
+
+  /**
+   * Output: the start positions of all occurrences of the pattern in the
+   *         text, in increasing order
+   *
+   * Time complexity: O((|P| + occurrences*sample_rate)*log(sigma)), plus
+   *                  sorting the occurrences
+   */
+  vector<i64> locate(const string &pattern) const {
+    pair<i64, i64> rows = find_rows(pattern);
+    vector<i64> positions;
+    positions.reserve(rows.second - rows.first);
+    for (i64 r = rows.first; r < rows.second; r++) {
+      positions.push_back(row_position(r));
+    }
+    sort(positions.begin(), positions.end());
+    return positions;
+  }
+
+  i64 size() const {
+    return n;
+  }
+
+  size_t memory_bytes() const {
+    return bwt.memory_bytes() + sampled.memory_bytes() + samples.size() * sizeof(i64)
+      + code.size() * sizeof(int) + smaller.size() * sizeof(i64);
+  }
+
+  /**
+   * Writes the index to a file, see FMIndexFileHeader, so that it can be
+   * built on a machine with room for the suffix array and used on one
+   * without.
+   *
+   * Output: true on success, otherwise false with errno set
+   *
+   * Time complexity: O(size of the index)
+   */
+  bool save(const string &path) const {
+    FMIndexFileHeader header = {};
+    copy(FM_INDEX_FILE_MAGIC, FM_INDEX_FILE_MAGIC + 8, header.magic);
+    header.version = FM_INDEX_FILE_VERSION;
+    header.byte_order = FM_INDEX_FILE_BYTE_ORDER;
+    header.sample_rate = sample_rate;
+    header.sigma = sigma;
+    header.n = n;
+    header.dollar_row = dollar_row;
+
+    ofstream out(path, ios::binary | ios::trunc);
+    out.write((const char *) &header, sizeof(header));
+    write_vector(out, code);
+    write_vector(out, smaller);
+    bwt.save(out);
+    sampled.save(out);
+    write_vector(out, samples);
+    out.close();
+    if (!out) {
+      if (errno == 0) {
+        errno = EIO;
+      }
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * Reads an index written by save() into index.
+   *
+   * Output: true on success, otherwise false with errno set, EINVAL if the
+   *         file is not an FM-index file this program can read
+   *
+   * Time complexity: O(size of the index)
+   */
+  static bool load(const string &path, FMIndex &index) {
+    ifstream in(path, ios::binary | ios::ate);
+    if (!in) {
+      return false;
+    }
+    u64 remaining = in.tellg();
+    in.seekg(0);
+
+    FMIndexFileHeader header;
+    index = FMIndex();
+    errno = EINVAL;
+    if (remaining < sizeof(header) || !in.read((char *) &header, sizeof(header))) {
+      return false;
+    }
+    remaining -= sizeof(header);
+    if (!equal(FM_INDEX_FILE_MAGIC, FM_INDEX_FILE_MAGIC + 8, header.magic)
+        || header.version != FM_INDEX_FILE_VERSION
+        || header.byte_order != FM_INDEX_FILE_BYTE_ORDER
+        || header.sample_rate == 0 || header.sample_rate > (uint32_t) numeric_limits<int>::max()
+        || header.sigma > 256 || header.n >= (uint64_t) numeric_limits<i64>::max()
+        || header.dollar_row > header.n) {
+      return false;
+    }
+    index.n = header.n;
+    index.sample_rate = header.sample_rate;
+    index.sigma = header.sigma;
+    index.dollar_row = header.dollar_row;
+
+    i64 sample_count = (index.n + index.sample_rate) / index.sample_rate;
+    if (!read_vector(in, index.code, remaining) || !read_vector(in, index.smaller, remaining)
+        || !index.bwt.load(in, index.n, remaining)
+        || !index.sampled.load(in, index.n + 1, remaining)
+        || !read_vector(in, index.samples, remaining)
+        || index.code.size() != 256 || (int) index.smaller.size() != index.sigma + 1
+        || (i64) index.samples.size() != sample_count
+        || index.sampled.rank1(index.n + 1) != sample_count) {
+      index = FMIndex();
+      return false;
+    }
+    errno = 0;
+    return true;
+  }
+};
@@ -0,0 +1,342 @@
+/**
+ * Johannes Kung johku144
+ *
+ * A generalized suffix array: the suffix array of many documents at once,
+ * for finding the longest substrings that occur in at least k of them.
+ *
+ * The documents are concatenated, each followed by its own separator. The
+ * separators are smaller than every character and all distinct, so no
+ * common prefix of two suffixes reaches past a separator, and the suffixes
+ * of every document keep their order. Every suffix array row also knows the
+ * document its suffix starts in.
+ *
+ * Time complexity:
+ *  - Construction: O(N + D) where N is the total length of the D documents,
+ *    see sa_is()
+ *  - Longest substrings in at least k documents: O(N + D)
+ * Memory consumption: about 20 bytes per character during construction, 16
+ * after
+ */
+#pragma once
+#include <algorithm>
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Sorts the suffixes of s[0...n-1] using SA-IS (induced sorting) by Nong, Zhang
+ * and Chan, as in labs/lab3/task2. All characters must be in 0...upper.
+ *
+ * Time complexity: O(n + upper)
+ */
+template <typename Char>
+vector<int> sa_is(const Char *s, int n, int upper) {
+  if (n == 0) {
+    return {};
+  }
+  if (n == 1) {
+    return {0};
+  }
+  if (n == 2) {
+    if (s[0] < s[1]) {
+      return {0, 1};
+    }
+    return {1, 0};
+  }
+
+  vector<int> sa(n);
+  vector<bool> is_s(n, false);
+  for (int i = n - 2; i >= 0; i--) {
+    is_s[i] = s[i] == s[i + 1] ? is_s[i + 1] : s[i] < s[i + 1];
+  }
+
+  // Start of the L-type and S-type parts of the bucket of every character
+  vector<int> start_l(upper + 1, 0), start_s(upper + 1, 0);
+  for (int i = 0; i < n; i++) {
+    if (!is_s[i]) {
+      start_s[s[i]]++;
+    }
+    else {
+      start_l[s[i] + 1]++;
+    }
+  }
+  for (int c = 0; c <= upper; c++) {
+    start_s[c] += start_l[c];
+    if (c < upper) {
+      start_l[c + 1] += start_s[c];
+    }
+  }
+
+  vector<int> bucket(upper + 1);
+  auto induce = [&](const vector<int> &lms) {
+    fill(sa.begin(), sa.end(), -1);
+    copy(start_s.begin(), start_s.end(), bucket.begin());
+    for (int d : lms) {
+      if (d != n) {
+        sa[bucket[s[d]]++] = d;
+      }
+    }
+    copy(start_l.begin(), start_l.end(), bucket.begin());
+    sa[bucket[s[n - 1]]++] = n - 1;
+    for (int i = 0; i < n; i++) {
+      int v = sa[i];
+      if (v >= 1 && !is_s[v - 1]) {
+        sa[bucket[s[v - 1]]++] = v - 1;
+      }
+    }
+    copy(start_l.begin(), start_l.end(), bucket.begin());
+    for (int i = n - 1; i >= 0; i--) {
+      int v = sa[i];
+      if (v >= 1 && is_s[v - 1]) {
+        sa[--bucket[s[v - 1] + 1]] = v - 1;
+      }
+    }
+  };
+
+  // The index of every LMS position among the LMS positions, -1 otherwise
+  vector<int> lms_index(n + 1, -1);
+  vector<int> lms;
+  for (int i = 1; i < n; i++) {
+    if (!is_s[i - 1] && is_s[i]) {
+      lms_index[i] = lms.size();
+      lms.push_back(i);
+    }
+  }
+  int m = lms.size();
+
+  induce(lms);
+  if (m > 0) {
+    vector<int> sorted_lms;
+    sorted_lms.reserve(m);
+    for (int v : sa) {
+      if (lms_index[v] != -1) {
+        sorted_lms.push_back(v);
+      }
+    }
+
+    // Name the LMS substrings in sorted order, equal substrings get the
+    // same name
+    vector<int> reduced(m);
+    int names = 0;
+    reduced[lms_index[sorted_lms[0]]] = 0;
+    for (int i = 1; i < m; i++) {
+      int l = sorted_lms[i - 1];
+      int r = sorted_lms[i];
+      int end_l = lms_index[l] + 1 < m ? lms[lms_index[l] + 1] : n;
+      int end_r = lms_index[r] + 1 < m ? lms[lms_index[r] + 1] : n;
+      bool same = true;
+      if (end_l - l != end_r - r) {
+        same = false;
+      }
+      else {
+        while (l < end_l && s[l] == s[r]) {
+          l++;
+          r++;
+        }
+        if (l == n || s[l] != s[r]) {
+          same = false;
+        }
+      }
+      if (!same) {
+        names++;
+      }
+      reduced[lms_index[sorted_lms[i]]] = names;
+    }
+
+    vector<int> reduced_sa = sa_is(reduced.data(), m, names);
+    for (int i = 0; i < m; i++) {
+      sorted_lms[i] = lms[reduced_sa[i]];
+    }
+    induce(sorted_lms);
+  }
+  return sa;
+}
+
+
+class GeneralizedSuffixArray {
+  // The concatenation: character c of a document is c + D, the separator
+  // after document d is d
+  vector<int> text;
+  int documents;
+  // Where every document starts in the concatenation, with the end of the
+  // concatenation last
+  vector<int> document_start;
+
+  vector<int> sa;
+  // lcp[i] is the longest common prefix of the suffixes in rows i and i+1
+  vector<int> lcp;
+  // The document of the suffix in every row
+  vector<int> document;
+
+  /**
+   * Implementation of Kasai's algorithm, as in labs/lab3/task3.
+   *
+   * Time complexity: O(N)
+   */
+  void construct_lcp_array() {
+    int n = this->text.size();
+    vector<int> rank(n);
+    for (int i = 0; i < n; i++) {
+      rank[this->sa[i]] = i;
+    }
+    this->lcp = vector<int>(max(0, n - 1), 0);
+    int k = 0;
+    for (int i = 0; i < n; i++) {
+      if (rank[i] == n - 1) {
+        k = 0;
+        continue;
+      }
+      int j = this->sa[rank[i] + 1];
+      while (i + k < n && j + k < n && this->text[i + k] == this->text[j + k]) {
+        k++;
+      }
+      this->lcp[rank[i]] = k;
+      k = max(0, k - 1);
+    }
+  }
+
+  /**
+   * Output: the length of the suffix in row r up to the end of its document
+   */
+  int suffix_length(int r) {
+    return this->document_start[this->document[r] + 1] - 1 - this->sa[r];
+  }
+
+public:
+  GeneralizedSuffixArray(const vector<string> &documents) : documents(documents.size()) {
+    int d = documents.size();
+    for (int i = 0; i < d; i++) {
+      this->document_start.push_back(this->text.size());
+      for (unsigned char c : documents[i]) {
+        this->text.push_back(c + d);
+      }
+      this->text.push_back(i);
+    }
+    this->document_start.push_back(this->text.size());
+
+    int n = this->text.size();
+    this->sa = sa_is(this->text.data(), n, 255 + d);
+    this->document = vector<int>(n);
+    vector<int> document_of = vector<int>(n);
+    for (int i = 0; i < d; i++) {
+      fill(document_of.begin() + this->document_start[i], document_of.begin() + this->document_start[i + 1], i);
+    }
+    for (int r = 0; r < n; r++) {
+      this->document[r] = document_of[this->sa[r]];
+    }
+    construct_lcp_array();
+  }
+
+  /**
+   * Finds the longest substrings that occur in at least k documents.
+   *
+   * The suffixes that start with a substring are consecutive rows, so a
+   * substring occurs in at least k documents if and only if there is a
+   * window of rows covering k documents whose suffixes all start with it,
+   * i.e. whose minimum LCP is at least its length. A sliding window over the
+   * rows keeps the smallest window that ends at every row and still covers k
+   * documents, with a count per document, and the minimum LCP of the window
+   * in a monotonic deque. A window of a single row (k = 1) stands for the
+   * whole rest of its document.
+   *
+   * Output: the length of the longest such substrings (0 if there are none),
+   *         and the start position in the concatenation of one occurrence of
+   *         each of them, in lexicographic order, see substring()
+   *
+   * Time complexity: O(N + D)
+   */
+  pair<int, vector<int>> longest_common_substrings(int k) {
+    k = max(k, 1);
+    int n = this->sa.size();
+    if (k > this->documents) {
+      return {0, {}};
+    }
+
+    vector<int> count = vector<int>(this->documents, 0);
+    int covered = 0;
+    // Rows i of the window with lcp[i] increasing, the front is the minimum
+    // of the window
+    deque<int> minimum;
+    int best = 0;
+    // The first row of every window with the best length
+    vector<int> rows;
+
+    int l = 0;
+    for (int r = 0; r < n; r++) {
+      if (count[this->document[r]]++ == 0) {
+        covered++;
+      }
+      if (r > 0) {
+        while (!minimum.empty() && this->lcp[minimum.back()] >= this->lcp[r - 1]) {
+          minimum.pop_back();
+        }
+        minimum.push_back(r - 1);
+      }
+
+      // Shrink the window as long as it covers k documents without row l
+      while (l < r && (count[this->document[l]] > 1 || covered > k)) {
+        if (--count[this->document[l]] == 0) {
+          covered--;
+        }
+        l++;
+      }
+      while (!minimum.empty() && minimum.front() < l) {
+        minimum.pop_front();
+      }
+      if (covered < k) {
+        continue;
+      }
+
+      int length = l == r ? suffix_length(r) : this->lcp[minimum.front()];
+      if (length > best) {
+        best = length;
+        rows.clear();
+      }
+      if (length == best && length > 0) {
+        rows.push_back(l);
+      }
+    }
+
+    // Windows with the same substring are next to each other, keep the first
+    // of every run whose rows share at least best characters
+    vector<int> positions;
+    int last = -1;
+    int shared = 0;
+    for (int row : rows) {
+      if (last != -1) {
+        for (int i = last; i < row; i++) {
+          shared = min(shared, this->lcp[i]);
+        }
+      }
+      if (last == -1 || shared < best) {
+        positions.push_back(this->sa[row]);
+        shared = best;
+      }
+      last = row;
+    }
+    return {best, positions};
+  }
+
+  /**
+   * Output: the substring of the given length at a position of the
+   *         concatenation, which must be inside a document
+   */
+  string substring(int position, int length) {
+    string s = string(length, '\0');
+    for (int i = 0; i < length; i++) {
+      s[i] = this->text[position + i] - this->documents;
+    }
+    return s;
+  }
+
+  /**
+   * Output: the document the position of the concatenation is in
+   */
+  int document_of(int position) {
+    return upper_bound(this->document_start.begin(), this->document_start.end(), position)
+      - this->document_start.begin() - 1;
+  }
+};
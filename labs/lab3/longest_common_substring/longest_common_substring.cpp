@@ -0,0 +1,63 @@
+/**
+ * Johannes Kung johku144
+ * Finding the longest substrings shared by more than half of a set of
+ * documents (or by at least k of them) with a generalized suffix array, see
+ * generalized_suffix_array.h.
+ *
+ * Input: test cases of a line with the number of documents n and n lines with
+ * one document each, ended by a test case with n = 0.
+ * Output: the longest substrings in lexicographic order, one per line, or "?"
+ * if there are none, with a blank line between test cases.
+ *
+ * Usage: longest_common_substring [k] < input
+ *
+ * Time complexity: O(N + n) per test case where N is the total length
+ */
+#include <cstdlib>
+#include <iostream>
+#include <ios>
+#include <string>
+#include <vector>
+#include "generalized_suffix_array.h"
+
+using namespace std;
+
+int main(int argc, char *argv[]) {
+  ios::sync_with_stdio(false);
+  cin.tie(nullptr);
+  cout.tie(nullptr);
+
+  int k = -1;
+  if (argc > 1) {
+    k = max(1, atoi(argv[1]));
+  }
+
+  bool first = true;
+  string line;
+  while (getline(cin, line)) {
+    int n = atoi(line.c_str());
+    if (n <= 0) {
+      break;
+    }
+    vector<string> documents = vector<string>(n);
+    for (string &document : documents) {
+      getline(cin, document);
+    }
+
+    GeneralizedSuffixArray gsa = GeneralizedSuffixArray(documents);
+    auto [length, positions] = gsa.longest_common_substrings(k == -1 ? n/2 + 1 : k);
+
+    if (!first) {
+      cout << "\n";
+    }
+    first = false;
+    if (positions.empty()) {
+      cout << "?\n";
+    }
+    for (int position : positions) {
+      cout << gsa.substring(position, length) << "\n";
+    }
+  }
+
+  cout.flush();
+}
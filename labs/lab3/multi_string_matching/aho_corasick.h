@@ -0,0 +1,187 @@
+/**
+ * Johannes Kung johku144
+ *
+ * The Aho-Corasick automaton for finding all occurrences of many patterns in
+ * a text in a single pass.
+ *
+ * The automaton is a trie of the patterns where every state also knows where
+ * to continue when the next character does not extend the current match. It
+ * is stored as a dense transition table over a compressed alphabet: only the
+ * characters that occur in some pattern get a column, all other characters
+ * share column 0, which always leads back to the root.
+ *
+ * Time complexity:
+ *  - Construction: O(S*A) where S <= sum of pattern lengths is the number of
+ *    states and A is the number of distinct characters in the patterns
+ *  - Matching: O(text + number of matches)
+ * Memory consumption: O(S*A) for the transition table, 4*(A+3) bytes per state
+ */
+#pragma once
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+struct AhoCorasick {
+  // The column of every character in the transition table
+  vector<int> char_class;
+  int alphabet;
+  int states;
+
+  // The next state from state s on a character of class k is
+  // transition[s*alphabet + k]. The root is state 0. After construction, a
+  // transition into a state where some pattern ends, directly or along its
+  // dictionary link, is stored bitwise negated (~t < 0), so that matching
+  // only has to look beyond the table when there is a match to report
+  vector<int> transition;
+
+  // For every state: the state of the longest proper suffix of its string
+  // that is in the trie (the failure link), and the closest state along the
+  // failure links where some pattern ends (-1 if none)
+  vector<int> fail;
+  vector<int> dictionary_link;
+
+  // The patterns ending in every state as a linked list: first_pattern[s] is
+  // the first one, next_pattern[p] the one after pattern p (-1 ends the list)
+  vector<int> first_pattern;
+  vector<int> next_pattern;
+  vector<int> pattern_length;
+
+  /**
+   * Builds the automaton for the given patterns. Empty patterns are ignored
+   * and never match.
+   *
+   * Time complexity: O(S*A)
+   */
+  AhoCorasick(vector<string> &patterns) {
+    char_class = vector<int>(256, 0);
+    alphabet = 1;
+    for (string &p : patterns) {
+      for (unsigned char c : p) {
+        if (char_class[c] == 0) {
+          char_class[c] = alphabet++;
+        }
+      }
+    }
+
+    // Build the trie, with -1 for missing transitions
+    states = 1;
+    transition = vector<int>(alphabet, -1);
+    first_pattern = {-1};
+    next_pattern = vector<int>(patterns.size(), -1);
+    pattern_length = vector<int>(patterns.size());
+    for (int i = 0; i < patterns.size(); i++) {
+      pattern_length[i] = patterns[i].size();
+      if (patterns[i].empty()) {
+        continue;
+      }
+      int s = 0;
+      for (unsigned char c : patterns[i]) {
+        int &t = transition[s*alphabet + char_class[c]];
+        if (t == -1) {
+          t = states++;
+          transition.resize(states*alphabet, -1);
+          first_pattern.push_back(-1);
+        }
+        s = transition[s*alphabet + char_class[c]];
+      }
+      next_pattern[i] = first_pattern[s];
+      first_pattern[s] = i;
+    }
+
+    renumber_breadth_first();
+
+    // The failure link of a state is found by following the transition of its
+    // last character from the failure link of its parent, which is complete
+    // as it is closer to the root. Missing transitions are filled in the same
+    // way, which turns the trie into a DFA so that matching never has to
+    // follow failure links. With the states in BFS order, every state is
+    // handled after all states closer to the root
+    fail = vector<int>(states, 0);
+    dictionary_link = vector<int>(states, -1);
+    for (int s = 0; s < states; s++) {
+      int f = fail[s];
+      if (s != 0) {
+        dictionary_link[s] = first_pattern[f] != -1 ? f : dictionary_link[f];
+      }
+      for (int k = 0; k < alphabet; k++) {
+        int &t = transition[s*alphabet + k];
+        if (t == -1) {
+          t = s == 0 ? 0 : transition[f*alphabet + k];
+        }
+        else if (s != 0) {
+          fail[t] = transition[f*alphabet + k];
+        }
+      }
+    }
+
+    for (int &t : transition) {
+      if (first_pattern[t] != -1 || dictionary_link[t] != -1) {
+        t = ~t;
+      }
+    }
+  }
+
+  /**
+   * Renumbers the states of the trie in BFS order. Matching mostly stays
+   * close to the root, so this keeps the rows of the transition table that
+   * are used the most next to each other in memory.
+   *
+   * Time complexity: O(S*A)
+   */
+  void renumber_breadth_first() {
+    vector<int> order = {0};
+    vector<int> new_id = vector<int>(states, -1);
+    new_id[0] = 0;
+    for (int i = 0; i < order.size(); i++) {
+      int s = order[i];
+      for (int k = 0; k < alphabet; k++) {
+        int t = transition[s*alphabet + k];
+        if (t != -1) {
+          new_id[t] = order.size();
+          order.push_back(t);
+        }
+      }
+    }
+
+    vector<int> renumbered = vector<int>(states*alphabet);
+    vector<int> renumbered_patterns = vector<int>(states);
+    for (int i = 0; i < states; i++) {
+      for (int k = 0; k < alphabet; k++) {
+        int t = transition[order[i]*alphabet + k];
+        renumbered[i*alphabet + k] = t == -1 ? -1 : new_id[t];
+      }
+      renumbered_patterns[i] = first_pattern[order[i]];
+    }
+    transition = renumbered;
+    first_pattern = renumbered_patterns;
+  }
+
+  /**
+   * Finds all occurrences of all patterns in the text.
+   *
+   * Output: (pattern index, start position) of every occurrence, ordered by
+   *         the position the occurrence ends at
+   *
+   * Time complexity: O(text + number of matches)
+   */
+  vector<pair<int, int>> find_all(const string &text) {
+    vector<pair<int, int>> matches;
+    int s = 0;
+    for (int i = 0; i < text.size(); i++) {
+      s = transition[s*alphabet + char_class[(unsigned char) text[i]]];
+      if (s >= 0) {
+        continue;
+      }
+      s = ~s;
+      int t = first_pattern[s] != -1 ? s : dictionary_link[s];
+      for (; t != -1; t = dictionary_link[t]) {
+        for (int p = first_pattern[t]; p != -1; p = next_pattern[p]) {
+          matches.push_back({p, i - pattern_length[p] + 1});
+        }
+      }
+    }
+    return matches;
+  }
+};
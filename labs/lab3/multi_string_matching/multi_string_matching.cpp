@@ -0,0 +1,57 @@
+/**
+ * Johannes Kung johku144
+ *
+ * Finding all occurrences of several patterns in a string at once using the
+ * Aho-Corasick automaton.
+ *
+ * Input: the number of patterns n, n lines with a pattern each and a line with
+ *        the text, repeated until the end of the input
+ * Output: for every pattern, the positions in the text where it occurs
+ *
+ * Time complexity: O(S*A + text + number of matches), see aho_corasick.h
+ */
+#include <iostream>
+#include <ios>
+#include <string>
+#include <utility>
+#include <vector>
+#include "aho_corasick.h"
+
+using namespace std;
+
+int main() {
+  ios::sync_with_stdio(false);
+  cin.tie(nullptr);
+  cout.tie(nullptr);
+
+  int n;
+  string text;
+  while (cin >> n) {
+    cin.ignore();
+    vector<string> patterns = vector<string>(n);
+    for (int i = 0; i < n; i++) {
+      getline(cin, patterns[i]);
+    }
+    getline(cin, text);
+
+    AhoCorasick automaton = AhoCorasick(patterns);
+    vector<vector<int>> positions = vector<vector<int>>(n);
+    for (pair<int, int> &match : automaton.find_all(text)) {
+      positions[match.first].push_back(match.second);
+    }
+
+    // Matches are found in order of their end, which for a single pattern is
+    // also the order of their start
+    for (vector<int> &p : positions) {
+      for (int i = 0; i < p.size(); i++) {
+        cout << p[i];
+        if (i < p.size() - 1) {
+          cout << " ";
+        }
+      }
+      cout << "\n";
+    }
+  }
+
+  cout.flush();
+}
@@ -0,0 +1,71 @@
+/**
+ * Johannes Kung johku144
+ *
+ * Finding a pattern in a file of any size, which is read in chunks instead of
+ * being kept in memory, using the Knuth-Morris-Pratt algorithm.
+ *
+ * Usage: stream_matching [pattern [file]]
+ * Reads standard input if no file is given, and outputs the byte offset of
+ * every occurrence of the pattern, one per line. Without a pattern, the first
+ * line of standard input is the pattern and the rest is the text.
+ *
+ * Time complexity: O(pattern + file size), see streaming_kmp.h
+ * Memory consumption: O(pattern + chunk size)
+ */
+#include <cerrno>
+#include <cstdio>
+#include <iostream>
+#include <ios>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include "streaming_kmp.h"
+
+using namespace std;
+
+int main(int argc, char *argv[]) {
+  ios::sync_with_stdio(false);
+  cout.tie(nullptr);
+
+  string pattern;
+  if (argc > 1) {
+    pattern = argv[1];
+  }
+  else {
+    // One byte at a time, so nothing after the line is consumed
+    char c;
+    ssize_t size;
+    while ((size = read(0, &c, 1)) != 0) {
+      if (size < 0 && errno == EINTR) {
+        continue;
+      }
+      if (size < 0 || c == '\n') {
+        break;
+      }
+      pattern.push_back(c);
+    }
+  }
+  if (pattern.empty()) {
+    cerr << "Usage: " << argv[0] << " [pattern [file]]\n";
+    return 2;
+  }
+
+  int fd = 0;
+  if (argc > 2) {
+    fd = open(argv[2], O_RDONLY);
+    if (fd < 0) {
+      perror(argv[2]);
+      return 1;
+    }
+  }
+
+  i64 count = search_file(fd, pattern, cout);
+  cout.flush();
+  if (count < 0) {
+    perror("read");
+    return 1;
+  }
+  if (fd != 0) {
+    close(fd);
+  }
+}
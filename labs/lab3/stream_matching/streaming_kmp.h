@@ -0,0 +1,149 @@
+/**
+ * Johannes Kung johku144
+ *
+ * Knuth-Morris-Pratt matching over a text that arrives in chunks, e.g. a file
+ * larger than memory read piece by piece.
+ *
+ * Only the prefix function of the pattern and the current state of the
+ * matcher, the length of the longest prefix of the pattern that is a suffix
+ * of the text read so far, are kept between chunks. A match may therefore
+ * span any number of chunks, and positions are reported as absolute offsets
+ * from the start of the text.
+ *
+ * Time complexity: O(pattern + text)
+ * Memory consumption: O(pattern), plus the chunk buffer in search_file()
+ */
+#pragma once
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+using namespace std;
+using i64 = int64_t;
+
+/**
+ * Implementation of the string prefix function for Knuth-Morris-Pratt algorithm
+ * as done by CP-Algorithms (https://cp-algorithms.com/string/prefix-function.html).
+ *
+ * Time complexity: O(n) where n is the length of the given string s.
+ */
+vector<int> prefix_function(const string &s) {
+  vector<int> pi(s.size());
+  for (int i = 1; i < s.size(); i++) {
+    int j = pi[i-1];
+    while (j > 0 && s[i] != s[j]) {
+      j = pi[j-1];
+    }
+    if (s[i] == s[j]) {
+      j++;
+    }
+    pi[i] = j;
+  }
+  return pi;
+}
+
+class StreamingKMP {
+  string pattern;
+  vector<int> pi;
+
+  // Length of the longest prefix of the pattern that is a suffix of the text
+  // read so far
+  int matched = 0;
+
+  // Number of bytes of the text read so far
+  i64 offset = 0;
+
+public:
+  /**
+   * The pattern must not be empty.
+   */
+  StreamingKMP(const string &pattern) : pattern(pattern), pi(prefix_function(pattern)) {}
+
+  /**
+   * Reads the next chunk of the text and appends the absolute start offset of
+   * every occurrence of the pattern that ends in this chunk to positions.
+   *
+   * Time complexity: O(size) amortised
+   */
+  void feed(const char *chunk, size_t size, vector<i64> &positions) {
+    int m = pattern.size();
+    for (size_t i = 0; i < size; i++) {
+      if (matched == 0) {
+        // Nothing to carry over, so skip straight to the next occurrence of
+        // the first character of the pattern. memchr is vectorised
+        const void *next = memchr(chunk + i, pattern[0], size - i);
+        if (next == nullptr) {
+          break;
+        }
+        i = (const char *) next - chunk;
+      }
+      while (matched > 0 && (matched == m || chunk[i] != pattern[matched])) {
+        matched = pi[matched-1];
+      }
+      if (chunk[i] == pattern[matched]) {
+        matched++;
+      }
+      if (matched == m) {
+        positions.push_back(offset + (i64) i - m + 1);
+      }
+    }
+    offset += size;
+  }
+
+  /**
+   * Output: the number of bytes of the text read so far
+   */
+  i64 bytes_read() {
+    return offset;
+  }
+
+  /**
+   * Starts over with a new text.
+   */
+  void reset() {
+    matched = 0;
+    offset = 0;
+  }
+};
+
+/**
+ * Searches the whole file behind a file descriptor, e.g. a file or a pipe,
+ * reading it with read(2) in chunks of the given size, and writes the offset
+ * of every occurrence to out, one per line. Reads interrupted by a signal are
+ * retried.
+ *
+ * Output: the number of occurrences, or -1 if reading failed
+ *
+ * Time complexity: O(pattern + file size)
+ * Memory consumption: O(pattern + chunk_size + occurrences in one chunk)
+ */
+i64 search_file(int fd, const string &pattern, ostream &out, size_t chunk_size = 1 << 20) {
+  StreamingKMP matcher = StreamingKMP(pattern);
+  vector<char> buffer = vector<char>(chunk_size);
+  vector<i64> positions;
+  i64 count = 0;
+  while (true) {
+    ssize_t size = read(fd, buffer.data(), chunk_size);
+    if (size < 0 && errno == EINTR) {
+      continue;
+    }
+    if (size < 0) {
+      return -1;
+    }
+    if (size == 0) {
+      break;
+    }
+
+    positions.clear();
+    matcher.feed(buffer.data(), size, positions);
+    for (i64 p : positions) {
+      out << p << "\n";
+    }
+    count += positions.size();
+  }
+  return count;
+}
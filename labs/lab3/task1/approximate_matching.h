@@ -0,0 +1,198 @@
+/**
+ * Johannes Kung johku144
+ *
+ * Approximate string matching with bit-parallel algorithms: finding where a
+ * pattern occurs in a text with at most k mismatches (Hamming distance), or
+ * with at most k insertions, deletions and substitutions (edit distance).
+ *
+ * Both algorithms keep one bit per pattern character in 64-bit words, so a
+ * pattern of length m needs W = ceil(m/64) words and every text character is
+ * handled with O(W) word operations.
+ *
+ * Time complexity:
+ *  - Hamming distance (Shift-And): O(k*W*text + 256*W + pattern)
+ *  - Edit distance (Myers): O(W*text + 256*W + pattern)
+ * Memory consumption: O(256*W + k*W)
+ */
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+using i64 = int64_t;
+using u64 = uint64_t;
+
+/**
+ * For every character c, a bit vector with bit i set if pattern[i] == c.
+ * The vector of character c is stored in words c*W, ..., c*W+W-1.
+ */
+vector<u64> character_masks(const string &pattern, int words) {
+  vector<u64> masks = vector<u64>(256*words, 0);
+  for (int i = 0; i < pattern.size(); i++) {
+    unsigned char c = pattern[i];
+    masks[c*words + i/64] |= (u64) 1 << (i % 64);
+  }
+  return masks;
+}
+
+/**
+ * Finds the start positions of all substrings of length |pattern| of the
+ * phrase that differ from the pattern in at most k characters, using the
+ * Shift-And algorithm extended to mismatches.
+ *
+ * After reading phrase[j], bit i of state d is set if pattern[0...i] matches
+ * the phrase ending at j with at most d mismatches. It either matched with at
+ * most d mismatches before and the next characters are equal, or it matched
+ * with at most d-1 mismatches before and the next characters are not:
+ *
+ *   state[d] = (shift(state[d]) & mask[c]) | shift(old state[d-1])
+ *
+ * where shift moves every bit up and sets bit 0, the empty prefix.
+ *
+ * Time complexity: O(k*W*phrase)
+ */
+vector<i64> hamming_find(const string &pattern, const string &phrase, int k) {
+  vector<i64> positions;
+  int m = pattern.size();
+  i64 n = phrase.size();
+  if (m == 0) {
+    for (i64 i = 0; i <= n; i++) {
+      positions.push_back(i);
+    }
+    return positions;
+  }
+  k = min(k, m);
+
+  int words = (m + 63) / 64;
+  vector<u64> masks = character_masks(pattern, words);
+  vector<u64> state = vector<u64>((k + 1)*words, 0);
+  u64 last_bit = (u64) 1 << ((m - 1) % 64);
+
+  // The bit shifted out of every state from the previous word
+  vector<u64> carry = vector<u64>(k + 1);
+  for (i64 j = 0; j < n; j++) {
+    const u64 *mask = &masks[(unsigned char) phrase[j] * words];
+    fill(carry.begin(), carry.end(), 1);
+    for (int w = 0; w < words; w++) {
+      // The shifted state d-1 from before this character
+      u64 lower_shifted = 0;
+      for (int d = 0; d <= k; d++) {
+        u64 &s = state[d*words + w];
+        u64 shifted = (s << 1) | carry[d];
+        carry[d] = s >> 63;
+        s = (shifted & mask[w]) | lower_shifted;
+        lower_shifted = shifted;
+      }
+    }
+    if (state[k*words + words - 1] & last_bit) {
+      positions.push_back(j - m + 1);
+    }
+  }
+  return positions;
+}
+
+/**
+ * One column step of Myers' algorithm on a block of 64 rows of the edit
+ * distance matrix, as formulated by Hyyrö for multiple blocks.
+ *
+ * positive/negative have a bit set for every row where the distance increases
+ * or decreases by one compared to the row above (the vertical differences).
+ * matches are the rows where the pattern character equals the text character.
+ * horizontal_in is the horizontal difference of the row above the block.
+ *
+ * Output: the horizontal difference of the row given by out_bit
+ */
+int myers_block(u64 &positive, u64 &negative, u64 matches, int horizontal_in, u64 out_bit) {
+  u64 in_negative = horizontal_in < 0 ? 1 : 0;
+  u64 in_positive = horizontal_in > 0 ? 1 : 0;
+
+  u64 x_vertical = matches | negative;
+  matches |= in_negative;
+  u64 x_horizontal = (((matches & positive) + positive) ^ positive) | matches;
+  u64 h_positive = negative | ~(x_horizontal | positive);
+  u64 h_negative = positive & x_horizontal;
+
+  int horizontal_out = 0;
+  if (h_positive & out_bit) {
+    horizontal_out = 1;
+  }
+  else if (h_negative & out_bit) {
+    horizontal_out = -1;
+  }
+
+  h_positive = (h_positive << 1) | in_positive;
+  h_negative = (h_negative << 1) | in_negative;
+  positive = h_negative | ~(x_vertical | h_positive);
+  negative = h_positive & x_vertical;
+  return horizontal_out;
+}
+
+/**
+ * Finds the end positions of all substrings of the phrase with an edit
+ * distance of at most k to the pattern, using Myers' bit-vector algorithm.
+ *
+ * Column j of the matrix holds the edit distance between every prefix of the
+ * pattern and the best substring of the phrase ending at j, which is stored
+ * as vertical differences in blocks of 64 rows. Row 0 is 0 in every column
+ * as a match may start anywhere. The distance of the whole pattern is
+ * tracked by adding the horizontal difference of row m in every column.
+ *
+ * Time complexity: O(W*phrase)
+ */
+vector<i64> myers_find_ends(const string &pattern, const string &phrase, int k) {
+  vector<i64> ends;
+  int m = pattern.size();
+  int words = (m + 63) / 64;
+  vector<u64> masks = character_masks(pattern, words);
+
+  // Column 0: the distance to the empty string is the length of the prefix
+  vector<u64> positive = vector<u64>(words, ~(u64) 0);
+  vector<u64> negative = vector<u64>(words, 0);
+  u64 last_bit = (u64) 1 << ((m - 1) % 64);
+  int distance = m;
+
+  for (i64 j = 0; j < (i64) phrase.size(); j++) {
+    const u64 *mask = &masks[(unsigned char) phrase[j] * words];
+    int horizontal = 0;
+    for (int w = 0; w < words - 1; w++) {
+      horizontal = myers_block(positive[w], negative[w], mask[w], horizontal, (u64) 1 << 63);
+    }
+    distance += myers_block(positive[words - 1], negative[words - 1], mask[words - 1], horizontal, last_bit);
+    if (distance <= k) {
+      ends.push_back(j);
+    }
+  }
+  return ends;
+}
+
+/**
+ * Finds the start positions of all substrings of the phrase with an edit
+ * distance of at most k to the pattern, i.e. the positions where an
+ * approximate occurrence may start, in increasing order.
+ *
+ * Myers' algorithm finds where approximate occurrences end. Running it on the
+ * reversed phrase with the reversed pattern finds where they end in the
+ * reversed phrase, which is where they start in the phrase.
+ *
+ * Time complexity: O(W*phrase)
+ */
+vector<i64> edit_distance_find(const string &pattern, const string &phrase, int k) {
+  vector<i64> positions;
+  i64 n = phrase.size();
+  if (pattern.empty()) {
+    for (i64 i = 0; i <= n; i++) {
+      positions.push_back(i);
+    }
+    return positions;
+  }
+
+  string reversed_pattern = string(pattern.rbegin(), pattern.rend());
+  string reversed_phrase = string(phrase.rbegin(), phrase.rend());
+  vector<i64> ends = myers_find_ends(reversed_pattern, reversed_phrase, k);
+  for (i64 i = (i64) ends.size() - 1; i >= 0; i--) {
+    positions.push_back(n - 1 - ends[i]);
+  }
+  return positions;
+}
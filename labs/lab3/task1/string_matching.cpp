@@ -1,15 +1,33 @@
 /**
  * Johannes Kung johku144
- * Finding a pattern in a string using the Knuth-Morris-Pratt algorithm.
+ * Finding a pattern in a string using a SIMD filter on the first and last
+ * character of the pattern, with the Knuth-Morris-Pratt algorithm as fallback.
  *
- * Time complexity: O(text + pattern)
+ * Alternatively finds approximate occurrences with at most k mismatches or at
+ * most k edits, see approximate_matching.h.
+ *
+ * Usage: string_matching [threads | --hamming k | --edit k] < input
+ *
+ * Time complexity: O(text + pattern), divided among threads for long texts
  */
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <ios>
 #include <string>
+#include <thread>
 #include <vector>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include "approximate_matching.h"
 
 using namespace std;
+using i64 = int64_t;
 
 /**
  * Implementation of the string prefix function for Knuth-Morris-Pratt algorithm
@@ -17,7 +35,7 @@ using namespace std;
  *
  * Time complexity: O(n) where n is the length of the given string s.
  */
-vector<int> prefix_function(string s) {
+vector<int> prefix_function(const string &s) {
   vector<int> pi(s.size());
   // Calculate pi(i) for each i = 1,..., |s|-1
   // (pi(0) = 0)
@@ -46,36 +64,202 @@ vector<int> prefix_function(string s) {
 
 /**
  * Implementation of the Knuth-Morris-Pratt algorithm to find occurences of 
- * a pattern in a string.
+ * a pattern in a string that start at positions from, ..., to-1.
+ *
+ * The prefix function is only calculated for the pattern. While scanning the
+ * phrase, j is the length of the longest prefix of the pattern that is also a
+ * suffix of the phrase read so far, and it is updated in the same way as in
+ * prefix_function(). When j reaches the length of the pattern, the pattern
+ * ends at position i.
+ *
+ * Time complexity: O(pattern + to - from)
+ */
+void kmp_find(const string &pattern, const string &phrase, i64 from, i64 to, vector<i64> &positions) {
+  vector<int> pi = prefix_function(pattern);
+  int m = pattern.size();
+  i64 end = min((i64) phrase.size(), to + m - 1);
+  int j = 0;
+  for (i64 i = from; i < end; i++) {
+    while (j > 0 && (j == m || phrase[i] != pattern[j])) {
+      j = pi[j-1];
+    }
+    if (phrase[i] == pattern[j]) {
+      j++;
+    }
+    if (j == m) {
+      positions.push_back(i - m + 1);
+    }
+  }
+}
+
+/**
+ * Finds occurences of a non-empty pattern in a string that start at
+ * positions begin, ..., end-1, and appends them to positions. Characters up
+ * to position end+|pattern|-2 are read.
+ *
+ * Candidate positions are found by comparing blocks of the phrase with the
+ * first and the last character of the pattern using SIMD instructions (AVX2 if
+ * the compiler targets it, otherwise SSE2). Only positions where both match
+ * are compared with the whole pattern using memcmp. For most patterns this
+ * skips almost all positions and reads the phrase only once.
+ *
+ * On periodic patterns like "aaaa" most positions can be candidates, making
+ * the verification O(pattern*phrase). If the bytes compared exceed a constant
+ * times the bytes scanned, the rest of the phrase is searched with KMP, which
+ * keeps the worst case linear.
+ *
+ * Time complexity: O(pattern + end - begin)
+ */
+void find_range(const string &pattern, const string &phrase, i64 begin, i64 end, vector<i64> &positions) {
+  i64 m = pattern.size();
+  i64 n = phrase.size();
+  if (m > n) {
+    return;
+  }
+
+  const char *text = phrase.data();
+  const char *p = pattern.data();
+  i64 candidates_end = min(end, n - m + 1);
+  i64 compared = 0;
+  auto too_many_compared = [&](i64 scanned_end) {
+    return compared > 4*(scanned_end - begin) + 4*m;
+  };
+
+  i64 i = begin;
+#if defined(__AVX2__)
+  const int BLOCK = 32;
+  __m256i first = _mm256_set1_epi8(p[0]);
+  __m256i last = _mm256_set1_epi8(p[m-1]);
+  for (; i + BLOCK <= candidates_end; i += BLOCK) {
+    __m256i block_first = _mm256_loadu_si256((const __m256i *) (text + i));
+    __m256i block_last = _mm256_loadu_si256((const __m256i *) (text + i + m - 1));
+    unsigned mask = _mm256_movemask_epi8(_mm256_and_si256(
+          _mm256_cmpeq_epi8(block_first, first),
+          _mm256_cmpeq_epi8(block_last, last)));
+#elif defined(__SSE2__)
+  const int BLOCK = 16;
+  __m128i first = _mm_set1_epi8(p[0]);
+  __m128i last = _mm_set1_epi8(p[m-1]);
+  for (; i + BLOCK <= candidates_end; i += BLOCK) {
+    __m128i block_first = _mm_loadu_si128((const __m128i *) (text + i));
+    __m128i block_last = _mm_loadu_si128((const __m128i *) (text + i + m - 1));
+    unsigned mask = _mm_movemask_epi8(_mm_and_si128(
+          _mm_cmpeq_epi8(block_first, first),
+          _mm_cmpeq_epi8(block_last, last)));
+#endif
+#if defined(__AVX2__) || defined(__SSE2__)
+    // Every set bit is a position where the first and last characters match
+    while (mask != 0) {
+      i64 candidate = i + __builtin_ctz(mask);
+      if (memcmp(text + candidate, p, m) == 0) {
+        positions.push_back(candidate);
+      }
+      compared += m;
+      mask &= mask - 1;
+    }
+    if (too_many_compared(i + BLOCK)) {
+      kmp_find(pattern, phrase, i + BLOCK, candidates_end, positions);
+      return;
+    }
+  }
+#endif
+
+  // The remaining positions, one at a time
+  for (; i < candidates_end; i++) {
+    if (text[i] == p[0] && text[i + m - 1] == p[m-1]) {
+      if (memcmp(text + i, p, m) == 0) {
+        positions.push_back(i);
+      }
+      compared += m;
+      if (too_many_compared(i + 1)) {
+        kmp_find(pattern, phrase, i + 1, candidates_end, positions);
+        return;
+      }
+    }
+  }
+}
+
+/**
+ * Finds occurences of a pattern in a string.
  *
- * Time complexity: O(pattern + phrase)
+ * Time complexity: O(pattern + phrase), see find_range()
  */
-vector<int> find(string pattern, string phrase) {
-  // Add the pattern onto the beginning of the phrase, with a delimiting character
-  // in between.
-  //
-  // The prefix function returns the length of the longest prefix of each substring
-  // phrase[0...i] such that the prefix is also a suffix of the substring. If 
-  // this length is the same as the length of the pattern, then this prefix 
-  // is exactly the pattern since it was appended to the beginning of the phrase.
-  //
-  // This tells us that the pattern can be found at position i - the lenght of 
-  // the pattern in the modified phrase, ending at position i.
-  //
-  vector<int> positions;
-  vector<int> pi = prefix_function(pattern + "#" + phrase);
-  for (int i = 0; i < pi.size(); i++) {
-    if (pi[i] == pattern.size()) {
-      positions.push_back(i - 2*pattern.size());
+vector<i64> find(const string &pattern, const string &phrase) {
+  vector<i64> positions;
+  if (pattern.empty()) {
+    // The empty pattern occurs at every position, including the end
+    for (i64 i = 0; i <= (i64) phrase.size(); i++) {
+      positions.push_back(i);
     }
+    return positions;
+  }
+  find_range(pattern, phrase, 0, phrase.size(), positions);
+  return positions;
+}
+
+/**
+ * Finds occurences of a pattern in a string using several threads.
+ *
+ * The start positions are split into one contiguous range per thread. The
+ * chunk of the phrase a thread reads is its range extended by |pattern|-1
+ * characters, so consecutive chunks overlap by |pattern|-1 characters and an
+ * occurrence crossing a chunk border is still found, but only by the thread
+ * whose range it starts in. The results of the threads are therefore disjoint
+ * and sorted, and are simply concatenated in order.
+ *
+ * Short phrases are searched by a single thread, as starting the threads
+ * would take longer than the search.
+ *
+ * Time complexity: O(pattern + phrase/threads) per thread
+ */
+vector<i64> parallel_find(const string &pattern, const string &phrase, int threads) {
+  const i64 MIN_CHUNK = 1 << 20;
+  threads = min((i64) threads, (i64) phrase.size() / MIN_CHUNK);
+  if (threads <= 1 || pattern.empty()) {
+    return find(pattern, phrase);
+  }
+
+  i64 n = phrase.size();
+  vector<vector<i64>> found = vector<vector<i64>>(threads);
+  vector<thread> workers;
+  for (int t = 0; t < threads; t++) {
+    i64 begin = n * t / threads;
+    i64 end = n * (t + 1) / threads;
+    workers.push_back(thread([&, t, begin, end]() {
+      find_range(pattern, phrase, begin, end, found[t]);
+    }));
+  }
+  for (thread &worker : workers) {
+    worker.join();
+  }
+
+  vector<i64> positions;
+  for (vector<i64> &f : found) {
+    positions.insert(positions.end(), f.begin(), f.end());
   }
   return positions;
 }
 
-int main() {
+int main(int argc, char *argv[]) {
   ios::sync_with_stdio(false);
   cin.tie(nullptr);
   cout.tie(nullptr);
+
+  int threads = 1;
+  int hamming = -1;
+  int edit_distance = -1;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--hamming") == 0 && i + 1 < argc) {
+      hamming = max(0, atoi(argv[++i]));
+    }
+    else if (strcmp(argv[i], "--edit") == 0 && i + 1 < argc) {
+      edit_distance = max(0, atoi(argv[++i]));
+    }
+    else {
+      threads = max(1, atoi(argv[i]));
+    }
+  }
+
   string pattern, phrase;
   while (true) {
     getline(cin, pattern);
@@ -84,10 +268,19 @@ int main() {
       break;
     }
 
-    vector<int> positions = find(pattern, phrase);
+    vector<i64> positions;
+    if (hamming >= 0) {
+      positions = hamming_find(pattern, phrase, hamming);
+    }
+    else if (edit_distance >= 0) {
+      positions = edit_distance_find(pattern, phrase, edit_distance);
+    }
+    else {
+      positions = parallel_find(pattern, phrase, threads);
+    }
 
     // Print out result with nice formatting
-    for (int i = 0; i < positions.size(); i++) {
+    for (size_t i = 0; i < positions.size(); i++) {
       cout << positions[i];
       if (i < positions.size() - 1) {
         cout << " ";
@@ -5,48 +5,365 @@
  * A suffix array contains the order of a lexicographic sort on all suffixes 
  * of a given string. 
  *
+ * The suffix array is constructed with SA-IS in linear time by default, the
+ * original prefix doubling construction, or a parallel version of it, may
+ * still be selected.
+ *
+ * Usage: suffix_array [--prefix-doubling | --parallel [threads]] < input
+ *
  * Time complexities:
- *  - Suffix array construction: O(n*log(n)) 
+ *  - Suffix array construction: O(n) with SA-IS, O(n*log(n)) with prefix
+ *    doubling (divided among the threads with --parallel)
  *  - Querying the array: O(1)
  */
 #include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
 #include <iostream>
 #include <ios>
 #include <string>
+#include <thread>
 #include <vector>
 
 using namespace std;
+using u64 = uint64_t;
 int ALPHABET = 256;
 
+enum class SuffixArrayConstruction {
+  PREFIX_DOUBLING,
+  SA_IS,
+  PARALLEL_PREFIX_DOUBLING,
+};
+
+/**
+ * Sorts the suffixes of s[0...n-1] using SA-IS (induced sorting) by Nong, Zhang
+ * and Chan, implemented as in the AtCoder Library
+ * (https://github.com/atcoder/ac-library/blob/master/atcoder/string.hpp).
+ * All characters must be in 0...upper.
+ *
+ * Every suffix is S-type if it is smaller than the suffix after it and L-type
+ * otherwise, and an S-type suffix after an L-type one is a leftmost S-type
+ * (LMS) suffix. If the LMS suffixes are sorted, one left-to-right pass puts
+ * the L-type suffixes in place and one right-to-left pass the S-type ones,
+ * as every suffix is ordered by its first character and then the suffix
+ * after it (induced sorting). The LMS suffixes are sorted by first inducing
+ * from them in text order, which sorts the substrings between consecutive
+ * LMS positions. Naming those substrings gives a string of at most n/2
+ * characters, whose suffix array is found recursively and gives the order of
+ * the LMS suffixes.
+ *
+ * Time complexity: O(n + upper)
+ */
+template <typename Char>
+vector<int> sa_is(const Char *s, int n, int upper) {
+  if (n == 0) {
+    return {};
+  }
+  if (n == 1) {
+    return {0};
+  }
+  if (n == 2) {
+    if (s[0] < s[1]) {
+      return {0, 1};
+    }
+    return {1, 0};
+  }
+
+  vector<int> sa(n);
+  vector<bool> is_s(n, false);
+  for (int i = n - 2; i >= 0; i--) {
+    is_s[i] = s[i] == s[i + 1] ? is_s[i + 1] : s[i] < s[i + 1];
+  }
+
+  // Start of the L-type and S-type parts of the bucket of every character
+  vector<int> start_l(upper + 1, 0), start_s(upper + 1, 0);
+  for (int i = 0; i < n; i++) {
+    if (!is_s[i]) {
+      start_s[s[i]]++;
+    }
+    else {
+      start_l[s[i] + 1]++;
+    }
+  }
+  for (int c = 0; c <= upper; c++) {
+    start_s[c] += start_l[c];
+    if (c < upper) {
+      start_l[c + 1] += start_s[c];
+    }
+  }
+
+  vector<int> bucket(upper + 1);
+  auto induce = [&](const vector<int> &lms) {
+    fill(sa.begin(), sa.end(), -1);
+    copy(start_s.begin(), start_s.end(), bucket.begin());
+    for (int d : lms) {
+      if (d != n) {
+        sa[bucket[s[d]]++] = d;
+      }
+    }
+    copy(start_l.begin(), start_l.end(), bucket.begin());
+    sa[bucket[s[n - 1]]++] = n - 1;
+    for (int i = 0; i < n; i++) {
+      int v = sa[i];
+      if (v >= 1 && !is_s[v - 1]) {
+        sa[bucket[s[v - 1]]++] = v - 1;
+      }
+    }
+    copy(start_l.begin(), start_l.end(), bucket.begin());
+    for (int i = n - 1; i >= 0; i--) {
+      int v = sa[i];
+      if (v >= 1 && is_s[v - 1]) {
+        sa[--bucket[s[v - 1] + 1]] = v - 1;
+      }
+    }
+  };
+
+  // The index of every LMS position among the LMS positions, -1 otherwise
+  vector<int> lms_index(n + 1, -1);
+  vector<int> lms;
+  for (int i = 1; i < n; i++) {
+    if (!is_s[i - 1] && is_s[i]) {
+      lms_index[i] = lms.size();
+      lms.push_back(i);
+    }
+  }
+  int m = lms.size();
+
+  induce(lms);
+  if (m > 0) {
+    vector<int> sorted_lms;
+    sorted_lms.reserve(m);
+    for (int v : sa) {
+      if (lms_index[v] != -1) {
+        sorted_lms.push_back(v);
+      }
+    }
+
+    // Name the LMS substrings in sorted order, equal substrings get the
+    // same name
+    vector<int> reduced(m);
+    int names = 0;
+    reduced[lms_index[sorted_lms[0]]] = 0;
+    for (int i = 1; i < m; i++) {
+      int l = sorted_lms[i - 1];
+      int r = sorted_lms[i];
+      int end_l = lms_index[l] + 1 < m ? lms[lms_index[l] + 1] : n;
+      int end_r = lms_index[r] + 1 < m ? lms[lms_index[r] + 1] : n;
+      bool same = true;
+      if (end_l - l != end_r - r) {
+        same = false;
+      }
+      else {
+        while (l < end_l && s[l] == s[r]) {
+          l++;
+          r++;
+        }
+        if (l == n || s[l] != s[r]) {
+          same = false;
+        }
+      }
+      if (!same) {
+        names++;
+      }
+      reduced[lms_index[sorted_lms[i]]] = names;
+    }
+
+    vector<int> reduced_sa = sa_is(reduced.data(), m, names);
+    for (int i = 0; i < m; i++) {
+      sorted_lms[i] = lms[reduced_sa[i]];
+    }
+    induce(sorted_lms);
+  }
+  return sa;
+}
+
+/**
+ * Runs f(tid) for tid = 0, ..., threads-1, each in its own thread.
+ */
+void in_parallel(int threads, function<void(int)> f) {
+  vector<thread> workers;
+  for (int tid = 1; tid < threads; tid++) {
+    workers.push_back(thread(f, tid));
+  }
+  f(0);
+  for (thread &worker : workers) {
+    worker.join();
+  }
+}
+
+/**
+ * Stable LSD radix sort of keys, and the values along with them, on the
+ * lowest bits of the keys using several threads, 8 bits per pass.
+ *
+ * Every thread counts the digits in its own chunk, the counts give every
+ * thread its own range of every bucket, and then every thread moves its
+ * chunk into those ranges. Passes where all keys have the same digit are
+ * skipped.
+ *
+ * Time complexity: O(bits/8 * (n/threads + 256*threads)) per thread
+ */
+void parallel_radix_sort(vector<u64> &keys, vector<int> &values, int bits, int threads) {
+  const int RADIX = 256;
+  int n = keys.size();
+  vector<u64> sorted_keys(n);
+  vector<int> sorted_values(n);
+  vector<int> count(threads*RADIX);
+  auto chunk_begin = [&](int tid) {
+    return (int) ((long long) n * tid / threads);
+  };
+
+  for (int shift = 0; shift < bits; shift += 8) {
+    fill(count.begin(), count.end(), 0);
+    in_parallel(threads, [&](int tid) {
+      int *c = &count[tid*RADIX];
+      for (int i = chunk_begin(tid); i < chunk_begin(tid + 1); i++) {
+        c[(keys[i] >> shift) & (RADIX - 1)]++;
+      }
+    });
+
+    // Turn the counts into the start of the range of every thread in every
+    // bucket, in order of digit and then thread
+    int start = 0;
+    bool one_bucket = false;
+    for (int d = 0; d < RADIX; d++) {
+      int bucket_start = start;
+      for (int tid = 0; tid < threads; tid++) {
+        int c = count[tid*RADIX + d];
+        count[tid*RADIX + d] = start;
+        start += c;
+      }
+      one_bucket |= start - bucket_start == n;
+    }
+    if (one_bucket) {
+      continue;
+    }
+
+    in_parallel(threads, [&](int tid) {
+      int *next = &count[tid*RADIX];
+      for (int i = chunk_begin(tid); i < chunk_begin(tid + 1); i++) {
+        int j = next[(keys[i] >> shift) & (RADIX - 1)]++;
+        sorted_keys[j] = keys[i];
+        sorted_values[j] = values[i];
+      }
+    });
+    keys.swap(sorted_keys);
+    values.swap(sorted_values);
+  }
+}
+
+/**
+ * Sorts the suffixes of s[0...n-1] by prefix doubling using several threads.
+ *
+ * In round h every suffix has the rank of its first h characters, 1, 2, ...
+ * in sorted order, and the rank of the empty string past the end is 0. The
+ * rank of the first 2h characters of suffix i is then the rank of the pair
+ * (rank[i], rank[i+h]). Every round sorts these pairs packed into one 64-bit
+ * key with parallel_radix_sort(), and gives new ranks by a parallel prefix
+ * sum over the positions where the key changes. As soon as all ranks are
+ * distinct the suffixes are sorted, so only as many rounds as the longest
+ * repeated substring needs are run, usually far fewer than log(n).
+ *
+ * Time complexity: O(n*log(n)/threads + threads*log(n)) per thread
+ */
+vector<int> parallel_prefix_doubling(const unsigned char *s, int n, int threads) {
+  const int MIN_CHUNK = 1 << 16;
+  threads = max(1, min(threads, n / MIN_CHUNK));
+
+  vector<int> rank(n), order(n);
+  vector<u64> keys(n);
+  for (int i = 0; i < n; i++) {
+    rank[i] = s[i] + 1;
+    order[i] = i;
+  }
+
+  auto chunk_begin = [&](int tid) {
+    return (int) ((long long) n * tid / threads);
+  };
+  vector<int> chunk_ranks(threads + 1);
+  int max_rank = 256;
+  for (long long h = 1; n > 0; h *= 2) {
+    // Only as many bits as the current ranks need are sorted on
+    int rank_bits = 1;
+    while ((1LL << rank_bits) <= max_rank) {
+      rank_bits++;
+    }
+
+    in_parallel(threads, [&](int tid) {
+      for (int i = chunk_begin(tid); i < chunk_begin(tid + 1); i++) {
+        int j = order[i];
+        u64 second = j + h < n ? rank[j + h] : 0;
+        keys[i] = ((u64) rank[j] << rank_bits) | second;
+      }
+    });
+    parallel_radix_sort(keys, order, 2*rank_bits, threads);
+
+    // Count the new ranks that start in every chunk, then number them from
+    // the number of ranks in the chunks before
+    in_parallel(threads, [&](int tid) {
+      int ranks = 0;
+      for (int i = chunk_begin(tid); i < chunk_begin(tid + 1); i++) {
+        ranks += i == 0 || keys[i] != keys[i-1];
+      }
+      chunk_ranks[tid + 1] = ranks;
+    });
+    for (int tid = 0; tid < threads; tid++) {
+      chunk_ranks[tid + 1] += chunk_ranks[tid];
+    }
+    // The keys hold everything the old ranks are still needed for, so the
+    // new ranks overwrite them
+    in_parallel(threads, [&](int tid) {
+      int r = chunk_ranks[tid];
+      for (int i = chunk_begin(tid); i < chunk_begin(tid + 1); i++) {
+        r += i == 0 || keys[i] != keys[i-1];
+        rank[order[i]] = r;
+      }
+    });
+
+    max_rank = chunk_ranks[threads];
+    if (max_rank == n) {
+      break;
+    }
+  }
+  return order;
+}
+
 /**
  * Class for constructing the suffix array for a given string.
- * Constructing an instance is O(n*log(n)) while querying is O(1). n is the 
- * length of the string for which the suffix array was constructed.
+ * Constructing an instance is O(n) with SA-IS and O(n*log(n)) with prefix
+ * doubling while querying is O(1). n is the length of the string for which
+ * the suffix array was constructed.
  */
 class SuffixArray {
   vector<int> p;
 
   /**
-   * Given a string s, sorts all cyclic shifts of s. The resulting sorted ordering
-   * is saved in the private vector p.
+   * Given a string s, sorts all cyclic shifts of s followed by an end marker
+   * that is smaller than every character, so s may contain any byte. The
+   * resulting sorted ordering is saved in the private vector p.
    *
    * Time complexity: O(n*log(n)) where n is the length of s.
    */
-  void sort_cyclic_shifts(string &s) {
-    int n = s.size();
+  void sort_cyclic_shifts(const string &s) {
+    int n = s.size() + 1;
+    // The characters shifted by one, with the end marker as 0
+    auto symbol = [&](int i) {
+      return i < n - 1 ? (unsigned char) s[i] + 1 : 0;
+    };
     this->p = vector<int>(n);
-    vector<int> c(n), cnt(max(ALPHABET, n), 0);
+    vector<int> c(n), cnt(max(ALPHABET + 1, n), 0);
   
     // Iteration 0:
     // Perform a counting sort on cyclic substrings of length 1
     for (int i = 0; i < n; ++i) {
-      cnt[s[i]]++;
+      cnt[symbol(i)]++;
     }
-    for (int i = 1; i < ALPHABET; ++i) {
+    for (int i = 1; i <= ALPHABET; ++i) {
       cnt[i] += cnt[i-1];
     }
     for (int i = 0; i < n; ++i) {
-      this->p[--cnt[s[i]]] = i;
+      this->p[--cnt[symbol(i)]] = i;
     }
 
     // Construct equivalent classes: all substrings that are the same 
@@ -55,7 +372,7 @@ class SuffixArray {
     c[this->p[0]] = 0;
     int classes = 1;
     for (int i = 1; i < n; ++i) {
-      if (s[this->p[i]] != s[this->p[i-1]]) {
+      if (symbol(this->p[i]) != symbol(this->p[i-1])) {
         classes++;
       }
       c[this->p[i]] = classes - 1;
@@ -63,7 +380,8 @@ class SuffixArray {
 
     // Iteration 1 to log(n):
     vector<int> p_next(n), c_next(n);
-    for (int h = 0; (1 << h) < n; ++h) {
+    // Stop as soon as all classes are distinct, the order cannot change after
+    for (int h = 0; (1 << h) < n && classes < n; ++h) {
       // working on cyclic substrings of length 2^h
       // Such a substring can be split into two halves of length 2^(h-1) each
 
@@ -98,8 +416,16 @@ class SuffixArray {
       c_next[p_next[0]] = 0;
       classes = 1;
       for (int i = 1; i < n; ++i) {
-        pair<int, int> cur = {c[this->p[i]], c[(this->p[i] + (1<<h)) % n]};
-        pair<int, int> prev = {c[this->p[i-1]], c[(this->p[i-1] + (1<<h)) % n]};
+        int cur_second = this->p[i] + (1<<h);
+        int prev_second = this->p[i-1] + (1<<h);
+        if (cur_second >= n) {
+          cur_second -= n;
+        }
+        if (prev_second >= n) {
+          prev_second -= n;
+        }
+        pair<int, int> cur = {c[this->p[i]], c[cur_second]};
+        pair<int, int> prev = {c[this->p[i-1]], c[prev_second]};
         if(cur != prev) {
           classes++;
         }
@@ -112,9 +438,23 @@ class SuffixArray {
   }
 
 public:
-  SuffixArray(string &s) {
-    // Add a character to the end of s that is guaranteed to come first 
-    // lexicographically.
+  /**
+   * threads is only used by the parallel prefix doubling.
+   */
+  SuffixArray(string &s, SuffixArrayConstruction construction = SuffixArrayConstruction::SA_IS,
+      int threads = thread::hardware_concurrency()) {
+    // Characters are compared as unsigned, as in sort_cyclic_shifts()
+    if (construction == SuffixArrayConstruction::SA_IS) {
+      this->p = sa_is((const unsigned char *) s.data(), s.size(), ALPHABET - 1);
+      return;
+    }
+    if (construction == SuffixArrayConstruction::PARALLEL_PREFIX_DOUBLING) {
+      this->p = parallel_prefix_doubling((const unsigned char *) s.data(), s.size(), threads);
+      return;
+    }
+
+    // The cyclic shifts are sorted with an end marker after s that is
+    // guaranteed to come first lexicographically.
     //
     // This character is used as a separator in the cyclic shifts of s.
     // All characters to the right of the separator in a cyclic shift correspond
@@ -124,7 +464,6 @@ public:
     // equivalent to sorting the suffixes of s. Note that the suffix of length 1,
     // corresponding to the separator character, will be first in this ordering 
     // and should be removed to get the ordering of the suffixes of s.
-    s += '\0';
     this->sort_cyclic_shifts(s);
     this->p.erase(this->p.begin());
   }
@@ -136,10 +475,23 @@ public:
   }
 };
 
-int main() {
+int main(int argc, char *argv[]) {
   ios::sync_with_stdio(false);
   cin.tie(nullptr);
   cout.tie(nullptr);
+
+  SuffixArrayConstruction construction = SuffixArrayConstruction::SA_IS;
+  int threads = thread::hardware_concurrency();
+  if (argc > 1 && strcmp(argv[1], "--prefix-doubling") == 0) {
+    construction = SuffixArrayConstruction::PREFIX_DOUBLING;
+  }
+  else if (argc > 1 && strcmp(argv[1], "--parallel") == 0) {
+    construction = SuffixArrayConstruction::PARALLEL_PREFIX_DOUBLING;
+    if (argc > 2) {
+      threads = max(1, atoi(argv[2]));
+    }
+  }
+
   string in;
   int n, q;
   while (true) {
@@ -149,7 +501,7 @@ int main() {
       break;
     }
 
-    SuffixArray sa = SuffixArray(in);
+    SuffixArray sa = SuffixArray(in, construction, threads);
 
     cin >> n;
     string out;
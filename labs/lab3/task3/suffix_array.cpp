@@ -5,68 +5,596 @@
  * Implemented using Kasai's algorithm as described by CP-Algorithms
  * (https://cp-algorithms.com/string/suffix-array.html#longest-common-prefix-of-two-substrings-without-additional-memory)
  *
+ * Usage: suffix_array [--prefix-doubling | --parallel [threads]] < input
+ *        suffix_array --save file < text
+ *        suffix_array --load file < patterns
+ * --save builds the suffix array of the whole standard input and writes it
+ * to the file, --load maps it and prints the number of occurrences of every
+ * line of standard input.
+ *
+ * Positions are stored as int for texts shorter than 2^31 characters, as
+ * 40-bit integers packed in 5 bytes for texts shorter than 2^39 characters
+ * and as 64-bit integers otherwise, see with_index_bytes().
+ *
  * Time complexities:
- *  - Suffix array construction: O(n*log(n)), see construct_suffix_array()
+ *  - Suffix array construction: O(n) with SA-IS, O(n*log(n)) with prefix
+ *    doubling (divided among the threads with --parallel), see
+ *    construct_suffix_array()
  *  - LCP array construciton: O(n), see the above link
+ *  - LCP of any two suffixes: O(1) with a sparse table over the LCP array,
+ *    built in O(n*log(n)) on first use, see lcp()
+ *  - Finding all occurrences of a pattern: O(|P| + log(n) + occurrences),
+ *    see find_range()
+ *  - Saving the arrays to a file: O(n), loading them: O(1) with mmap, see
+ *    SuffixArray::save() and SuffixArray::load()
  */
 #include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
 #include <iostream>
 #include <ios>
+#include <iterator>
+#include <limits>
+#include <memory>
 #include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 using namespace std;
+using u64 = uint64_t;
+using i64 = int64_t;
 int ALPHABET = 256;
 
+enum class SuffixArrayConstruction {
+  PREFIX_DOUBLING,
+  SA_IS,
+  PARALLEL_PREFIX_DOUBLING,
+};
+
+/**
+ * A signed 40-bit integer packed in 5 bytes, for suffix arrays of texts that
+ * are too long for int but where int64_t would waste 3 bytes per entry.
+ * The low 32 bits are stored as a uint32_t in the byte order of the machine,
+ * followed by the high 8 bits, and values are converted to and from int64_t
+ * for arithmetic.
+ */
+struct int40 {
+  static const i64 MAX = ((i64) 1 << 39) - 1;
+  uint8_t bytes[5];
+
+  int40() = default;
+  int40(i64 v) {
+    uint32_t low = v;
+    memcpy(bytes, &low, 4);
+    bytes[4] = v >> 32;
+  }
+
+  operator i64() const {
+    uint32_t low;
+    memcpy(&low, bytes, 4);
+    // The high byte is signed, which sign extends the value
+    return (i64) ((u64) (int8_t) bytes[4] << 32) | low;
+  }
+
+  int40 &operator++() {
+    return *this = *this + 1;
+  }
+  int40 &operator--() {
+    return *this = *this - 1;
+  }
+  int40 operator++(int) {
+    int40 old = *this;
+    ++*this;
+    return old;
+  }
+  int40 &operator+=(i64 v) {
+    return *this = *this + v;
+  }
+};
+
+/**
+ * The largest text length a suffix array with the given index type can hold.
+ */
+template <typename Index>
+i64 max_index() {
+  if constexpr (is_same<Index, int40>::value) {
+    return int40::MAX;
+  }
+  else {
+    return numeric_limits<Index>::max();
+  }
+}
+
+/**
+ * The number of bytes per entry of the smallest index type for a text of
+ * length n.
+ */
+int index_bytes(i64 n) {
+  if (n <= max_index<int>()) {
+    return sizeof(int);
+  }
+  if (n <= max_index<int40>()) {
+    return sizeof(int40);
+  }
+  return sizeof(i64);
+}
+
+/**
+ * Calls f with a value of the index type with the given number of bytes per
+ * entry: int, int40 or int64_t. f is a generic lambda that gets the type with
+ * decltype, e.g. to construct a SuffixArray<decltype(index)>, so that the type
+ * can be chosen at runtime from index_bytes() of the text length.
+ *
+ * Output: false if there is no index type of that size
+ */
+template <typename F>
+bool with_index_bytes(int bytes, F f) {
+  if (bytes == sizeof(int)) {
+    f(int());
+  }
+  else if (bytes == sizeof(int40)) {
+    f(int40());
+  }
+  else if (bytes == sizeof(i64)) {
+    f(i64());
+  }
+  else {
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Sorts the suffixes of s[0...n-1] using SA-IS (induced sorting) by Nong, Zhang
+ * and Chan, implemented as in the AtCoder Library
+ * (https://github.com/atcoder/ac-library/blob/master/atcoder/string.hpp).
+ * All characters must be in 0...upper.
+ *
+ * Every suffix is S-type if it is smaller than the suffix after it and L-type
+ * otherwise, and an S-type suffix after an L-type one is a leftmost S-type
+ * (LMS) suffix. If the LMS suffixes are sorted, one left-to-right pass puts
+ * the L-type suffixes in place and one right-to-left pass the S-type ones,
+ * as every suffix is ordered by its first character and then the suffix
+ * after it (induced sorting). The LMS suffixes are sorted by first inducing
+ * from them in text order, which sorts the substrings between consecutive
+ * LMS positions. Naming those substrings gives a string of at most n/2
+ * characters, whose suffix array is found recursively and gives the order of
+ * the LMS suffixes.
+ *
+ * Time complexity: O(n + upper)
+ */
+template <typename Index, typename Char>
+vector<Index> sa_is(const Char *s, i64 n, i64 upper) {
+  if (n == 0) {
+    return {};
+  }
+  if (n == 1) {
+    return {0};
+  }
+  if (n == 2) {
+    if (s[0] < s[1]) {
+      return {0, 1};
+    }
+    return {1, 0};
+  }
+
+  vector<Index> sa(n);
+  vector<bool> is_s(n, false);
+  for (i64 i = n - 2; i >= 0; i--) {
+    is_s[i] = s[i] == s[i + 1] ? is_s[i + 1] : s[i] < s[i + 1];
+  }
+
+  // Start of the L-type and S-type parts of the bucket of every character
+  vector<Index> start_l(upper + 1, 0), start_s(upper + 1, 0);
+  for (i64 i = 0; i < n; i++) {
+    if (!is_s[i]) {
+      start_s[s[i]]++;
+    }
+    else {
+      start_l[s[i] + 1]++;
+    }
+  }
+  for (i64 c = 0; c <= upper; c++) {
+    start_s[c] += start_l[c];
+    if (c < upper) {
+      start_l[c + 1] += start_s[c];
+    }
+  }
+
+  vector<Index> bucket(upper + 1);
+  auto induce = [&](const vector<Index> &lms) {
+    fill(sa.begin(), sa.end(), -1);
+    copy(start_s.begin(), start_s.end(), bucket.begin());
+    for (i64 d : lms) {
+      if (d != n) {
+        sa[bucket[s[d]]++] = d;
+      }
+    }
+    copy(start_l.begin(), start_l.end(), bucket.begin());
+    sa[bucket[s[n - 1]]++] = n - 1;
+    for (i64 i = 0; i < n; i++) {
+      i64 v = sa[i];
+      if (v >= 1 && !is_s[v - 1]) {
+        sa[bucket[s[v - 1]]++] = v - 1;
+      }
+    }
+    copy(start_l.begin(), start_l.end(), bucket.begin());
+    for (i64 i = n - 1; i >= 0; i--) {
+      i64 v = sa[i];
+      if (v >= 1 && is_s[v - 1]) {
+        sa[--bucket[s[v - 1] + 1]] = v - 1;
+      }
+    }
+  };
+
+  // The index of every LMS position among the LMS positions, -1 otherwise
+  vector<Index> lms_index(n + 1, -1);
+  vector<Index> lms;
+  for (i64 i = 1; i < n; i++) {
+    if (!is_s[i - 1] && is_s[i]) {
+      lms_index[i] = lms.size();
+      lms.push_back(i);
+    }
+  }
+  i64 m = lms.size();
+
+  induce(lms);
+  if (m > 0) {
+    vector<Index> sorted_lms;
+    sorted_lms.reserve(m);
+    for (i64 v : sa) {
+      if (lms_index[v] != -1) {
+        sorted_lms.push_back(v);
+      }
+    }
+
+    // Name the LMS substrings in sorted order, equal substrings get the
+    // same name
+    vector<Index> reduced(m);
+    i64 names = 0;
+    reduced[lms_index[sorted_lms[0]]] = 0;
+    for (i64 i = 1; i < m; i++) {
+      i64 l = sorted_lms[i - 1];
+      i64 r = sorted_lms[i];
+      i64 end_l = lms_index[l] + 1 < m ? (i64) lms[lms_index[l] + 1] : n;
+      i64 end_r = lms_index[r] + 1 < m ? (i64) lms[lms_index[r] + 1] : n;
+      bool same = true;
+      if (end_l - l != end_r - r) {
+        same = false;
+      }
+      else {
+        while (l < end_l && s[l] == s[r]) {
+          l++;
+          r++;
+        }
+        if (l == n || s[l] != s[r]) {
+          same = false;
+        }
+      }
+      if (!same) {
+        names++;
+      }
+      reduced[lms_index[sorted_lms[i]]] = names;
+    }
+
+    vector<Index> reduced_sa = sa_is<Index>(reduced.data(), m, names);
+    for (i64 i = 0; i < m; i++) {
+      sorted_lms[i] = lms[reduced_sa[i]];
+    }
+    induce(sorted_lms);
+  }
+  return sa;
+}
+
+/**
+ * Runs f(tid) for tid = 0, ..., threads-1, each in its own thread.
+ */
+void in_parallel(int threads, function<void(int)> f) {
+  vector<thread> workers;
+  for (int tid = 1; tid < threads; tid++) {
+    workers.push_back(thread(f, tid));
+  }
+  f(0);
+  for (thread &worker : workers) {
+    worker.join();
+  }
+}
+
+/**
+ * Stable LSD radix sort of keys, and the values along with them, on the
+ * lowest bits of the keys using several threads, 8 bits per pass.
+ *
+ * Every thread counts the digits in its own chunk, the counts give every
+ * thread its own range of every bucket, and then every thread moves its
+ * chunk into those ranges. Passes where all keys have the same digit are
+ * skipped.
+ *
+ * Time complexity: O(bits/8 * (n/threads + 256*threads)) per thread
+ */
+void parallel_radix_sort(vector<u64> &keys, vector<int> &values, int bits, int threads) {
+  const int RADIX = 256;
+  int n = keys.size();
+  vector<u64> sorted_keys(n);
+  vector<int> sorted_values(n);
+  vector<int> count(threads*RADIX);
+  auto chunk_begin = [&](int tid) {
+    return (int) ((long long) n * tid / threads);
+  };
+
+  for (int shift = 0; shift < bits; shift += 8) {
+    fill(count.begin(), count.end(), 0);
+    in_parallel(threads, [&](int tid) {
+      int *c = &count[tid*RADIX];
+      for (int i = chunk_begin(tid); i < chunk_begin(tid + 1); i++) {
+        c[(keys[i] >> shift) & (RADIX - 1)]++;
+      }
+    });
+
+    // Turn the counts into the start of the range of every thread in every
+    // bucket, in order of digit and then thread
+    int start = 0;
+    bool one_bucket = false;
+    for (int d = 0; d < RADIX; d++) {
+      int bucket_start = start;
+      for (int tid = 0; tid < threads; tid++) {
+        int c = count[tid*RADIX + d];
+        count[tid*RADIX + d] = start;
+        start += c;
+      }
+      one_bucket |= start - bucket_start == n;
+    }
+    if (one_bucket) {
+      continue;
+    }
+
+    in_parallel(threads, [&](int tid) {
+      int *next = &count[tid*RADIX];
+      for (int i = chunk_begin(tid); i < chunk_begin(tid + 1); i++) {
+        int j = next[(keys[i] >> shift) & (RADIX - 1)]++;
+        sorted_keys[j] = keys[i];
+        sorted_values[j] = values[i];
+      }
+    });
+    keys.swap(sorted_keys);
+    values.swap(sorted_values);
+  }
+}
+
+/**
+ * Sorts the suffixes of s[0...n-1] by prefix doubling using several threads.
+ *
+ * In round h every suffix has the rank of its first h characters, 1, 2, ...
+ * in sorted order, and the rank of the empty string past the end is 0. The
+ * rank of the first 2h characters of suffix i is then the rank of the pair
+ * (rank[i], rank[i+h]). Every round sorts these pairs packed into one 64-bit
+ * key with parallel_radix_sort(), and gives new ranks by a parallel prefix
+ * sum over the positions where the key changes. As soon as all ranks are
+ * distinct the suffixes are sorted, so only as many rounds as the longest
+ * repeated substring needs are run, usually far fewer than log(n).
+ *
+ * Time complexity: O(n*log(n)/threads + threads*log(n)) per thread
+ */
+vector<int> parallel_prefix_doubling(const unsigned char *s, int n, int threads) {
+  const int MIN_CHUNK = 1 << 16;
+  threads = max(1, min(threads, n / MIN_CHUNK));
+
+  vector<int> rank(n), order(n);
+  vector<u64> keys(n);
+  for (int i = 0; i < n; i++) {
+    rank[i] = s[i] + 1;
+    order[i] = i;
+  }
+
+  auto chunk_begin = [&](int tid) {
+    return (int) ((long long) n * tid / threads);
+  };
+  vector<int> chunk_ranks(threads + 1);
+  int max_rank = 256;
+  for (long long h = 1; n > 0; h *= 2) {
+    // Only as many bits as the current ranks need are sorted on
+    int rank_bits = 1;
+    while ((1LL << rank_bits) <= max_rank) {
+      rank_bits++;
+    }
+
+    in_parallel(threads, [&](int tid) {
+      for (int i = chunk_begin(tid); i < chunk_begin(tid + 1); i++) {
+        int j = order[i];
+        u64 second = j + h < n ? rank[j + h] : 0;
+        keys[i] = ((u64) rank[j] << rank_bits) | second;
+      }
+    });
+    parallel_radix_sort(keys, order, 2*rank_bits, threads);
+
+    // Count the new ranks that start in every chunk, then number them from
+    // the number of ranks in the chunks before
+    in_parallel(threads, [&](int tid) {
+      int ranks = 0;
+      for (int i = chunk_begin(tid); i < chunk_begin(tid + 1); i++) {
+        ranks += i == 0 || keys[i] != keys[i-1];
+      }
+      chunk_ranks[tid + 1] = ranks;
+    });
+    for (int tid = 0; tid < threads; tid++) {
+      chunk_ranks[tid + 1] += chunk_ranks[tid];
+    }
+    // The keys hold everything the old ranks are still needed for, so the
+    // new ranks overwrite them
+    in_parallel(threads, [&](int tid) {
+      int r = chunk_ranks[tid];
+      for (int i = chunk_begin(tid); i < chunk_begin(tid + 1); i++) {
+        r += i == 0 || keys[i] != keys[i-1];
+        rank[order[i]] = r;
+      }
+    });
+
+    max_rank = chunk_ranks[threads];
+    if (max_rank == n) {
+      break;
+    }
+  }
+  return order;
+}
+
+/**
+ * A read-only view of an array owned elsewhere, by a vector or a mapped file.
+ */
+template <typename T>
+struct ArrayView {
+  const T *data = nullptr;
+  i64 length = 0;
+
+  ArrayView() {}
+  ArrayView(const T *data, i64 length) : data(data), length(length) {}
+  ArrayView(const vector<T> &v) : data(v.data()), length(v.size()) {}
+
+  i64 operator[](i64 i) const {
+    return data[i];
+  }
+  const T *begin() const {
+    return data;
+  }
+  const T *end() const {
+    return data + length;
+  }
+  i64 size() const {
+    return length;
+  }
+  bool empty() const {
+    return length == 0;
+  }
+};
+
+/**
+ * The header of a suffix array file. It is followed by the text, the suffix
+ * array, the LCP array (n-1 entries) and the rank array, each at the given
+ * offset from the start of the file, which is a multiple of
+ * SUFFIX_ARRAY_FILE_ALIGNMENT. An offset of 0 means that the array is not
+ * stored. Arrays have entry_bytes bytes per entry, 4, 5 or 8 for the index
+ * types int, int40 and int64_t, in the byte order of the machine that wrote
+ * them, given by byte_order.
+ */
+struct SuffixArrayFileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order;
+  uint32_t entry_bytes;
+  uint32_t reserved;
+  uint64_t n;
+  uint64_t text_offset;
+  uint64_t sa_offset;
+  uint64_t lcp_offset;
+  uint64_t rank_offset;
+};
+
+const char SUFFIX_ARRAY_FILE_MAGIC[8] = {'S', 'U', 'F', 'F', 'I', 'X', 'A', 'R'};
+const uint32_t SUFFIX_ARRAY_FILE_VERSION = 1;
+const uint32_t SUFFIX_ARRAY_FILE_BYTE_ORDER = 0x01020304;
+const uint64_t SUFFIX_ARRAY_FILE_ALIGNMENT = 64;
+
+/**
+ * Reads the header of a suffix array file to find the index type it needs.
+ *
+ * Output: the number of bytes per entry, or -1 if the header could not be
+ *         read
+ */
+int suffix_array_file_entry_bytes(const string &path) {
+  SuffixArrayFileHeader header;
+  ifstream in(path, ios::binary);
+  if (!in.read((char *) &header, sizeof(header))) {
+    return -1;
+  }
+  return header.entry_bytes;
+}
+
 /**
  * Class for constructing the suffix array for a given string.
- * Constructing an instance is O(n*log(n)) while querying is O(1). n is the 
- * length of the string for which the suffix array was constructed.
+ * Constructing an instance is O(n) with SA-IS and O(n*log(n)) with prefix
+ * doubling while querying is O(1). n is the length of the string for which
+ * the suffix array was constructed.
  * Also constructs an lcp array from the suffix array which may be accesed 
  * using a getter-method.
+ *
+ * Positions and lengths are stored as Index, which must be able to hold n,
+ * see with_index_bytes(), and are returned as i64.
  */
+template <typename Index>
 class SuffixArray {
-  vector<int> p;
-  vector<int> lcp;
+  i64 n = 0;
+  // The text, kept for find_range(), the suffix array, the lcp array and
+  // the index of every suffix in p, i.e. the inverse of p. They point into
+  // the owned vectors below or into a mapped file
+  const char *text = nullptr;
+  ArrayView<Index> p;
+  ArrayView<Index> lcp_array;
+  ArrayView<Index> rank;
+  // Behind a pointer, so that text stays valid when the suffix array is
+  // moved even if the string is short enough to be stored inline
+  unique_ptr<const string> owned_text;
+  vector<Index> owned_p;
+  vector<Index> owned_lcp;
+  vector<Index> owned_rank;
+  // Unmaps the file when the last reference is gone
+  shared_ptr<const char> mapping;
+  // sparse_table[k][i] is the minimum of lcp_array[i...i+2^k-1], built on
+  // the first call to lcp(i, j)
+  vector<vector<Index>> sparse_table;
 
   /**
-   * Given a string s, sorts all cyclic shifts of s. The resulting sorted ordering
-   * is saved in the private vector p.
+   * Given a string s, sorts all cyclic shifts of s followed by an end marker
+   * that is smaller than every character, so s may contain any byte. The
+   * resulting sorted ordering is saved in the private vector p.
    *
    * Time complexity: O(n*log(n)) where n is the length of s.
    */
-  void sort_cyclic_shifts(string &s) {
-    int n = s.size();
-    this->p = vector<int>(n);
-    vector<int> c(n), cnt(max(ALPHABET, n), 0);
+  void sort_cyclic_shifts(const string &s) {
+    i64 n = s.size() + 1;
+    // The characters shifted by one, with the end marker as 0
+    auto symbol = [&](i64 i) {
+      return i < n - 1 ? (unsigned char) s[i] + 1 : 0;
+    };
+    this->owned_p = vector<Index>(n);
+    vector<Index> c(n), cnt(max((i64) ALPHABET + 1, n), 0);
   
     // Iteration 0:
     // Perform a counting sort on cyclic substrings of length 1
-    for (int i = 0; i < n; ++i) {
-      cnt[s[i]]++;
+    for (i64 i = 0; i < n; ++i) {
+      cnt[symbol(i)]++;
     }
-    for (int i = 1; i < ALPHABET; ++i) {
+    for (i64 i = 1; i <= ALPHABET; ++i) {
       cnt[i] += cnt[i-1];
     }
-    for (int i = 0; i < n; ++i) {
-      this->p[--cnt[s[i]]] = i;
+    for (i64 i = 0; i < n; ++i) {
+      this->owned_p[--cnt[symbol(i)]] = i;
     }
 
     // Construct equivalent classes: all substrings that are the same 
     // end up in the same class. Class indices also preserve the sorted order 
     // of the substrings
-    c[this->p[0]] = 0;
-    int classes = 1;
-    for (int i = 1; i < n; ++i) {
-      if (s[this->p[i]] != s[this->p[i-1]]) {
+    c[this->owned_p[0]] = 0;
+    i64 classes = 1;
+    for (i64 i = 1; i < n; ++i) {
+      if (symbol(this->owned_p[i]) != symbol(this->owned_p[i-1])) {
         classes++;
       }
-      c[this->p[i]] = classes - 1;
+      c[this->owned_p[i]] = classes - 1;
     }
 
     // Iteration 1 to log(n):
-    vector<int> p_next(n), c_next(n);
-    for (int h = 0; (1 << h) < n; ++h) {
+    vector<Index> p_next(n), c_next(n);
+    // Stop as soon as all classes are distinct, the order cannot change after
+    for (int h = 0; ((i64) 1 << h) < n && classes < n; ++h) {
       // working on cyclic substrings of length 2^h
       // Such a substring can be split into two halves of length 2^(h-1) each
 
@@ -75,38 +603,47 @@ class SuffixArray {
       // the substrings of length 2^(h-1) from which we can compare substrings 
       // and also check which one preceeds the other directly
       // => This sorting is therefore O(n)
-      for (int i = 0; i < n; ++i) {
-        p_next[i] = this->p[i] - (1 << h);
-        if (p_next[i] < 0) {
-          p_next[i] += n;
+      for (i64 i = 0; i < n; ++i) {
+        i64 shifted = this->owned_p[i] - ((i64) 1 << h);
+        if (shifted < 0) {
+          shifted += n;
         }
+        p_next[i] = shifted;
       }
 
       // Secondly, sort the substrings based on the first half using counting 
       // sort 
       // O(n)
       fill(cnt.begin(), cnt.begin() + classes, 0);
-      for (int i = 0; i < n; ++i) {
+      for (i64 i = 0; i < n; ++i) {
         cnt[c[p_next[i]]]++;
       }
-      for (int i = 1; i < classes; ++i) {
+      for (i64 i = 1; i < classes; ++i) {
         cnt[i] += cnt[i-1];
       }
-      for (int i = n-1; i >= 0; --i) {
-        this->p[--cnt[c[p_next[i]]]] = p_next[i];
+      for (i64 i = n-1; i >= 0; --i) {
+        this->owned_p[--cnt[c[p_next[i]]]] = p_next[i];
       }
 
       // Construct equivalence classes
       // O(n)
       c_next[p_next[0]] = 0;
       classes = 1;
-      for (int i = 1; i < n; ++i) {
-        pair<int, int> cur = {c[this->p[i]], c[(this->p[i] + (1<<h)) % n]};
-        pair<int, int> prev = {c[this->p[i-1]], c[(this->p[i-1] + (1<<h)) % n]};
+      for (i64 i = 1; i < n; ++i) {
+        i64 cur_second = this->owned_p[i] + ((i64) 1 << h);
+        i64 prev_second = this->owned_p[i-1] + ((i64) 1 << h);
+        if (cur_second >= n) {
+          cur_second -= n;
+        }
+        if (prev_second >= n) {
+          prev_second -= n;
+        }
+        pair<i64, i64> cur = {c[this->owned_p[i]], c[cur_second]};
+        pair<i64, i64> prev = {c[this->owned_p[i-1]], c[prev_second]};
         if(cur != prev) {
           classes++;
         }
-        c_next[this->p[i]] = classes - 1;
+        c_next[this->owned_p[i]] = classes - 1;
       }
       c.swap(c_next);
       // Done sorting substrings of length 2^h and constructing equivalence 
@@ -114,9 +651,27 @@ class SuffixArray {
     }
   }
 
-  void construct_suffix_array(string &s) {
-    // Add a character to the end of s that is guaranteed to come first 
-    // lexicographically.
+  /**
+   * Constructs the suffix array of s with the given algorithm. s is left
+   * unchanged.
+   */
+  void construct_suffix_array(const string &s, SuffixArrayConstruction construction, int threads) {
+    // Characters are compared as unsigned, as in sort_cyclic_shifts()
+    if constexpr (is_same<Index, int>::value) {
+      if (construction == SuffixArrayConstruction::PARALLEL_PREFIX_DOUBLING) {
+        this->owned_p = parallel_prefix_doubling((const unsigned char *) s.data(), s.size(), threads);
+        return;
+      }
+    }
+    // The parallel prefix doubling packs two ranks in 64 bits, so it is only
+    // available for int and SA-IS is used for longer texts
+    if (construction != SuffixArrayConstruction::PREFIX_DOUBLING) {
+      this->owned_p = sa_is<Index>((const unsigned char *) s.data(), s.size(), ALPHABET - 1);
+      return;
+    }
+
+    // The cyclic shifts are sorted with an end marker after s that is
+    // guaranteed to come first lexicographically.
     //
     // This character is used as a separator in the cyclic shifts of s.
     // All characters to the right of the separator in a cyclic shift correspond
@@ -126,65 +681,454 @@ class SuffixArray {
     // equivalent to sorting the suffixes of s. Note that the suffix of length 1,
     // corresponding to the separator character, will be first in this ordering 
     // and should be removed to get the ordering of the suffixes of s.
-    s += '\0';
     this->sort_cyclic_shifts(s);
-    this->p.erase(this->p.begin());
+    this->owned_p.erase(this->owned_p.begin());
   }
 
   /**
-   * Implementation of Kasai's algorithm for constructing an LCP array from 
-   * this suffix array. Assumes that construct_suffix_array() has been called 
-   * on the given string s before this method is called.
+   * Constructs the inverse of the suffix array.
    *
    * Time complexity: O(n)
    */
-  void construct_lcp_array(string &s) {
-    int n = s.size();
-    vector<int> rank(n, 0);
-    for (int i = 0; i < n; ++i) {
-      rank[this->p[i]] = i;
+  void construct_rank_array() {
+    this->owned_rank = vector<Index>(this->n, 0);
+    for (i64 i = 0; i < this->n; ++i) {
+      this->owned_rank[this->p[i]] = i;
     }
+    this->rank = ArrayView<Index>(this->owned_rank);
+  }
 
-    int k = 0;
-    this->lcp = vector<int>(n - 1, 0);
-    for (int i = 0; i < n; ++i) {
+  /**
+   * Implementation of Kasai's algorithm for constructing an LCP array from 
+   * this suffix array. Assumes that the text, the suffix array and the rank
+   * array have been set before this method is called.
+   *
+   * Time complexity: O(n)
+   */
+  void construct_lcp_array() {
+    i64 n = this->n;
+    const char *s = this->text;
+    this->owned_lcp = vector<Index>(max((i64) 0, n - 1), 0);
+    i64 k = 0;
+    for (i64 i = 0; i < n; ++i) {
       if(rank[i] == n - 1) {
         k = 0;
         continue;
       }
-      int j = this->p[rank[i] + 1];
+      i64 j = this->p[rank[i] + 1];
       while (i + k < n && j + k < n && s[i + k] == s[j + k]) {
         k++;
       }
-      this->lcp[rank[i]] = k;
-      k = max(0, k - 1);
+      this->owned_lcp[rank[i]] = k;
+      k = max((i64) 0, k - 1);
     }
+    this->lcp_array = ArrayView<Index>(this->owned_lcp);
+  }
+
+  /**
+   * Builds a sparse table over the lcp array, where level k holds the
+   * minimum of every range of 2^k lcp values. Any range is covered by two
+   * overlapping ranges of the same level, which makes range minimum queries
+   * O(1).
+   *
+   * Time complexity: O(n*log(n)), as is the memory consumption
+   */
+  void construct_sparse_table() {
+    i64 m = this->lcp_array.size();
+    this->sparse_table = {vector<Index>(this->lcp_array.begin(), this->lcp_array.end())};
+    for (int k = 1; ((i64) 1 << k) <= m; ++k) {
+      const vector<Index> &prev = this->sparse_table[k - 1];
+      i64 size = m - ((i64) 1 << k) + 1;
+      vector<Index> level(size);
+      for (i64 i = 0; i < size; ++i) {
+        level[i] = min((i64) prev[i], (i64) prev[i + ((i64) 1 << (k - 1))]);
+      }
+      this->sparse_table.push_back(level);
+    }
+  }
+
+  /**
+   * Returns the length of the longest common prefix of the suffixes with
+   * ranks l < r, the minimum of lcp_array[l...r-1].
+   *
+   * Time complexity: O(1), plus O(n*log(n)) on the first call
+   */
+  i64 range_lcp(i64 l, i64 r) {
+    if (this->sparse_table.empty()) {
+      construct_sparse_table();
+    }
+    int k = 63 - __builtin_clzll(r - l);
+    return min((i64) this->sparse_table[k][l], (i64) this->sparse_table[k][r - ((i64) 1 << k)]);
+  }
+
+  /**
+   * Binary search for the first suffix that does not start with a string
+   * smaller than the pattern, or with upper, the first suffix that starts
+   * with a string larger than it, using the LCP-accelerated search by Manber
+   * and Myers.
+   *
+   * The search keeps the bounds L < R, with the suffix at L before and the
+   * one at R after the sought position, and how many characters of the
+   * pattern each of them matches, l and r. Say l >= r. The midpoint M shares
+   * x = range_lcp(L, M) characters with L. If x > l, M is on the same side
+   * as L, and if x < l, M differs from the pattern at x and is after it.
+   * Only if x == l are characters compared, starting at l. Every compared
+   * character that matches increases max(l, r), which never decreases, so
+   * at most |P| + log(n) characters are compared.
+   *
+   * Time complexity: O(|P| + log(n))
+   */
+  i64 bound(const string &pattern, bool upper) {
+    i64 n = this->n;
+    i64 m = pattern.size();
+    // L = -1 and R = n stand for suffixes before and after all others
+    i64 L = -1, R = n;
+    i64 l = 0, r = 0;
+    while (R - L > 1) {
+      i64 M = (L + R) / 2;
+      i64 k;
+      if (l >= r && L >= 0) {
+        i64 x = range_lcp(L, M);
+        if (x > l) {
+          L = M;
+          continue;
+        }
+        if (x < l) {
+          R = M;
+          r = x;
+          continue;
+        }
+        k = l;
+      }
+      else if (r > l && R < n) {
+        i64 x = range_lcp(M, R);
+        if (x > r) {
+          R = M;
+          continue;
+        }
+        if (x < r) {
+          L = M;
+          l = x;
+          continue;
+        }
+        k = r;
+      }
+      else {
+        k = min(l, r);
+      }
+
+      // Compare the pattern with the suffix at M from character k on
+      i64 i = this->p[M];
+      while (k < m && i + k < n && this->text[i + k] == pattern[k]) {
+        k++;
+      }
+      bool before;
+      if (k == m) {
+        // The suffix starts with the pattern
+        before = upper;
+      }
+      else if (i + k == n) {
+        // The suffix is a proper prefix of the pattern
+        before = true;
+      }
+      else {
+        before = (unsigned char) this->text[i + k] < (unsigned char) pattern[k];
+      }
+
+      if (before) {
+        L = M;
+        l = k;
+      }
+      else {
+        R = M;
+        r = k;
+      }
+    }
+    return R;
   }
 
 public:
-  SuffixArray(string &s) {
-    construct_suffix_array(s);
-    construct_lcp_array(s);
+  /**
+   * An empty suffix array, e.g. to load() into.
+   */
+  SuffixArray() {}
+
+  /**
+   * The suffix array keeps the text, so pass it with move() to avoid holding
+   * it twice. threads is only used by the parallel prefix doubling.
+   */
+  SuffixArray(string s, SuffixArrayConstruction construction = SuffixArrayConstruction::SA_IS,
+      int threads = thread::hardware_concurrency())
+    : owned_text(make_unique<const string>(move(s))) {
+    this->n = this->owned_text->size();
+    this->text = this->owned_text->data();
+    construct_suffix_array(*this->owned_text, construction, threads);
+    this->p = ArrayView<Index>(this->owned_p);
+    construct_rank_array();
+    construct_lcp_array();
+  }
+
+  // The arrays may point into the owned vectors, which are not copied along
+  // with the pointers, but moving a vector keeps its buffer
+  SuffixArray(const SuffixArray &) = delete;
+  SuffixArray &operator=(const SuffixArray &) = delete;
+  SuffixArray(SuffixArray &&) = default;
+  SuffixArray &operator=(SuffixArray &&) = default;
+
+  /**
+   * Writes the text, the suffix array and optionally the LCP and rank arrays
+   * to a file, see SuffixArrayFileHeader.
+   *
+   * Output: true on success, otherwise false with errno set
+   *
+   * Time complexity: O(n)
+   */
+  bool save(const string &path, bool with_lcp = true, bool with_rank = true) {
+    SuffixArrayFileHeader header = {};
+    copy(SUFFIX_ARRAY_FILE_MAGIC, SUFFIX_ARRAY_FILE_MAGIC + 8, header.magic);
+    header.version = SUFFIX_ARRAY_FILE_VERSION;
+    header.byte_order = SUFFIX_ARRAY_FILE_BYTE_ORDER;
+    header.entry_bytes = sizeof(Index);
+    header.n = this->n;
+
+    // The sections in file order, each starting at an aligned offset
+    struct Section {
+      uint64_t offset;
+      const char *data;
+      uint64_t bytes;
+    };
+    vector<Section> sections;
+    uint64_t offset = sizeof(header);
+    auto add_section = [&](uint64_t &section_offset, const void *data, uint64_t bytes) {
+      offset = (offset + SUFFIX_ARRAY_FILE_ALIGNMENT - 1) / SUFFIX_ARRAY_FILE_ALIGNMENT * SUFFIX_ARRAY_FILE_ALIGNMENT;
+      section_offset = offset;
+      sections.push_back({offset, (const char *) data, bytes});
+      offset += bytes;
+    };
+    add_section(header.text_offset, this->text, this->n);
+    add_section(header.sa_offset, this->p.begin(), (uint64_t) this->n * sizeof(Index));
+    if (with_lcp) {
+      add_section(header.lcp_offset, this->lcp_array.begin(), (uint64_t) this->lcp_array.size() * sizeof(Index));
+    }
+    if (with_rank) {
+      add_section(header.rank_offset, this->rank.begin(), (uint64_t) this->n * sizeof(Index));
+    }
+
+    ofstream out(path, ios::binary | ios::trunc);
+    out.write((const char *) &header, sizeof(header));
+    uint64_t written = sizeof(header);
+    for (Section &section : sections) {
+      for (; written < section.offset; written++) {
+        out.put('\0');
+      }
+      out.write(section.data, section.bytes);
+      written += section.bytes;
+    }
+    out.close();
+    if (!out) {
+      if (errno == 0) {
+        errno = EIO;
+      }
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * Maps a file written by save() into memory and points sa at the arrays in
+   * it without copying them. The LCP and rank arrays are constructed in O(n)
+   * if the file does not contain them. The mapping lives as long as sa.
+   *
+   * Output: true on success, otherwise false with errno set, EINVAL if the
+   *         file is not a suffix array file this program can read
+   *
+   * Time complexity: O(1) if the file has all arrays, otherwise O(n)
+   */
+  static bool load(const string &path, SuffixArray &sa) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+      close(fd);
+      return false;
+    }
+    uint64_t size = st.st_size;
+    if (size < sizeof(SuffixArrayFileHeader)) {
+      close(fd);
+      errno = EINVAL;
+      return false;
+    }
+    void *data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+      return false;
+    }
+    shared_ptr<const char> mapping = shared_ptr<const char>((const char *) data,
+        [size](const char *d) { munmap((void *) d, size); });
+
+    const SuffixArrayFileHeader *header = (const SuffixArrayFileHeader *) data;
+    auto section_fits = [&](uint64_t offset, uint64_t entries, uint64_t entry_bytes) {
+      return offset % SUFFIX_ARRAY_FILE_ALIGNMENT == 0 && offset <= size
+        && entries <= (size - offset) / entry_bytes;
+    };
+    uint64_t n = header->n;
+    if (!equal(SUFFIX_ARRAY_FILE_MAGIC, SUFFIX_ARRAY_FILE_MAGIC + 8, header->magic)
+        || header->version != SUFFIX_ARRAY_FILE_VERSION
+        || header->byte_order != SUFFIX_ARRAY_FILE_BYTE_ORDER
+        || header->entry_bytes != sizeof(Index)
+        || n > (uint64_t) max_index<Index>()
+        || header->text_offset == 0 || !section_fits(header->text_offset, n, 1)
+        || header->sa_offset == 0 || !section_fits(header->sa_offset, n, sizeof(Index))
+        || (header->lcp_offset != 0 && !section_fits(header->lcp_offset, n == 0 ? 0 : n - 1, sizeof(Index)))
+        || (header->rank_offset != 0 && !section_fits(header->rank_offset, n, sizeof(Index)))) {
+      errno = EINVAL;
+      return false;
+    }
+
+    const char *base = mapping.get();
+    sa = SuffixArray();
+    sa.n = n;
+    sa.mapping = mapping;
+    sa.text = base + header->text_offset;
+    sa.p = ArrayView<Index>((const Index *) (base + header->sa_offset), n);
+    if (header->rank_offset != 0) {
+      sa.rank = ArrayView<Index>((const Index *) (base + header->rank_offset), n);
+    }
+    else {
+      sa.construct_rank_array();
+    }
+    if (header->lcp_offset != 0) {
+      sa.lcp_array = ArrayView<Index>((const Index *) (base + header->lcp_offset), n == 0 ? 0 : n - 1);
+    }
+    else {
+      sa.construct_lcp_array();
+    }
+    return true;
   }
 
   // Given an index i for the substring 0...i, returns the index of the 
   // substring in the lexicographic order of the substrings.
-  int get_suffix(int i) {
+  i64 get_suffix(i64 i) {
     return this->p[i];
   }
 
+  // Given an index i for the substring i...n-1, returns the index of it in
+  // the lexicographic order of the suffixes, the inverse of get_suffix().
+  i64 get_rank(i64 i) {
+    return this->rank[i];
+  }
+
   /**
-   * Returns the lcp array for this suffix array.
+   * Returns the lcp array for this suffix array: lcp[i] is the length of the
+   * longest common prefix of the suffixes get_suffix(i) and get_suffix(i+1).
    */
-  vector<int> get_lcp() {
-    return this->lcp;
+  ArrayView<Index> get_lcp() {
+    return this->lcp_array;
+  }
+
+  /**
+   * Returns the length of the longest common prefix of the suffixes starting
+   * at i and j, the minimum of the lcp values between their ranks. The
+   * longest common prefix of the substrings of length a and b starting at i
+   * and j is min(lcp(i, j), a, b).
+   *
+   * Time complexity: O(1), plus O(n*log(n)) on the first call
+   */
+  i64 lcp(i64 i, i64 j) {
+    if (i == j) {
+      return this->n - i;
+    }
+    if (this->sparse_table.empty()) {
+      construct_sparse_table();
+    }
+    i64 l = this->rank[i];
+    i64 r = this->rank[j];
+    if (l > r) {
+      swap(l, r);
+    }
+    return range_lcp(l, r);
+  }
+
+  /**
+   * Returns the suffix array interval [begin, end) of the suffixes that
+   * start with the pattern, so the pattern occurs at get_suffix(i) for every
+   * i in begin...end-1.
+   *
+   * Time complexity: O(|P| + log(n)), plus O(n*log(n)) on the first call
+   */
+  pair<i64, i64> find_range(const string &pattern) {
+    return {bound(pattern, false), bound(pattern, true)};
+  }
+
+  /**
+   * Returns the start positions of all occurrences of the pattern in the
+   * text, in suffix array order.
+   *
+   * Time complexity: O(|P| + log(n) + occurrences)
+   */
+  vector<i64> occurrences(const string &pattern) {
+    pair<i64, i64> range = find_range(pattern);
+    return vector<i64>(this->p.begin() + range.first, this->p.begin() + range.second);
+  }
+
+  i64 size() {
+    return this->n;
   }
 };
 
-int main() {
+int main(int argc, char *argv[]) {
   ios::sync_with_stdio(false);
   cin.tie(nullptr);
   cout.tie(nullptr);
+
+  SuffixArrayConstruction construction = SuffixArrayConstruction::SA_IS;
+  int threads = thread::hardware_concurrency();
+  if (argc > 2 && strcmp(argv[1], "--save") == 0) {
+    string text = string(istreambuf_iterator<char>(cin), istreambuf_iterator<char>());
+    bool saved = false;
+    with_index_bytes(index_bytes(text.size()), [&](auto index) {
+      SuffixArray<decltype(index)> sa = SuffixArray<decltype(index)>(move(text), construction, threads);
+      saved = sa.save(argv[2]);
+    });
+    if (!saved) {
+      perror(argv[2]);
+      return 1;
+    }
+    return 0;
+  }
+  if (argc > 2 && strcmp(argv[1], "--load") == 0) {
+    bool loaded = false;
+    with_index_bytes(suffix_array_file_entry_bytes(argv[2]), [&](auto index) {
+      SuffixArray<decltype(index)> sa;
+      loaded = SuffixArray<decltype(index)>::load(argv[2], sa);
+      string pattern;
+      while (loaded && getline(cin, pattern)) {
+        pair<i64, i64> range = sa.find_range(pattern);
+        cout << range.second - range.first << "\n";
+      }
+    });
+    if (!loaded) {
+      if (errno == 0) {
+        errno = EINVAL;
+      }
+      perror(argv[2]);
+      return 1;
+    }
+    cout.flush();
+    return 0;
+  }
+  if (argc > 1 && strcmp(argv[1], "--prefix-doubling") == 0) {
+    construction = SuffixArrayConstruction::PREFIX_DOUBLING;
+  }
+  else if (argc > 1 && strcmp(argv[1], "--parallel") == 0) {
+    construction = SuffixArrayConstruction::PARALLEL_PREFIX_DOUBLING;
+    if (argc > 2) {
+      threads = max(1, atoi(argv[2]));
+    }
+  }
+
   string in;
   int n;
   while (true) {
@@ -196,9 +1140,14 @@ int main() {
       break;
     }
 
-    SuffixArray sa = SuffixArray(in);
-    vector<int> lcp = sa.get_lcp();
-    cout << *max_element(lcp.begin(), lcp.end()) << "\n"; 
+    with_index_bytes(index_bytes(in.size()), [&](auto index) {
+      SuffixArray<decltype(index)> sa = SuffixArray<decltype(index)>(move(in), construction, threads);
+      i64 longest = 0;
+      for (i64 l : sa.get_lcp()) {
+        longest = max(longest, l);
+      }
+      cout << longest << "\n";
+    });
   }
 
   cout.flush();
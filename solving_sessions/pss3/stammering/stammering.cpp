@@ -2,8 +2,8 @@
 #include <iostream>
 #include <ios>
 #include <string>
+#include <utility>
 #include <vector>
-#include "string_matching.h"
 #include "suffix_array.h"
 
 using namespace std;
@@ -26,8 +26,8 @@ int main() {
     cin.ignore();
     getline(cin, in);
 
-    SuffixArray sa(in);
-    vector<int> lcp = sa.get_lcp();
+    SuffixArray sa(move(in));
+    const vector<int> &lcp = sa.get_lcp();
     vector<pair<int, int>> lcp_sorted;
     for (int i = 0; i < lcp.size(); ++i) {
       lcp_sorted.push_back({i, lcp[i]});
@@ -38,10 +38,10 @@ int main() {
     int best_length = -1;
     for (pair<int, int> e : lcp_sorted) {
       if (e.second == 0) continue;
-      string s = in.substr(sa.get_suffix(e.first), e.second);
-      vector<int> occurences = find_pattern(s, in);
+      string s = sa.get_text().substr(sa.get_suffix(e.first), e.second);
+      vector<int> occurences = sa.occurrences(s);
       if (occurences.size() >= m) {
-        best_pos = occurences.back();
+        best_pos = *max_element(occurences.begin(), occurences.end());
         best_length = s.size();
         break;
       }
@@ -1,14 +1,19 @@
 #pragma once
 #include <algorithm>
 #include <string>
+#include <utility>
 #include <vector>
 
 using namespace std;
 int ALPHABET = 256;
 
 class SuffixArray {
+  string text;
   vector<int> p;
   vector<int> lcp;
+  vector<int> rank;
+  // sparse_table[k][i] is the minimum of lcp[i...i+2^k-1]
+  vector<vector<int>> sparse_table;
 
   void sort_cyclic_shifts(string &s) {
     int n = s.size();
@@ -18,13 +23,13 @@ class SuffixArray {
     // Iteration 0:
     // Perform a counting sort on cyclic substrings of length 1
     for (int i = 0; i < n; ++i) {
-      cnt[s[i]]++;
+      cnt[(unsigned char) s[i]]++;
     }
     for (int i = 1; i < ALPHABET; ++i) {
       cnt[i] += cnt[i-1];
     }
     for (int i = 0; i < n; ++i) {
-      this->p[--cnt[s[i]]] = i;
+      this->p[--cnt[(unsigned char) s[i]]] = i;
     }
 
     // Construct equivalent classes: all substrings that are the same 
@@ -91,6 +96,7 @@ class SuffixArray {
     s += '\0';
     this->sort_cyclic_shifts(s);
     this->p.erase(this->p.begin());
+    s.pop_back();
   }
 
   /**
@@ -99,7 +105,10 @@ class SuffixArray {
    */
   void construct_lcp_array(string &s) {
     int n = s.size();
-    vector<int> rank(n, 0);
+    this->rank = vector<int>(n, 0);
+    if (n == 0) {
+      return;
+    }
     for (int i = 0; i < n; ++i) {
       rank[this->p[i]] = i;
     }
@@ -118,19 +127,138 @@ class SuffixArray {
       this->lcp[rank[i]] = k;
       k = max(0, k-1);
     }
+
+    this->sparse_table = {this->lcp};
+    for (int h = 1; (1 << h) <= n - 1; ++h) {
+      const vector<int> &prev = this->sparse_table[h-1];
+      vector<int> level(n - (1 << h));
+      for (int i = 0; i < level.size(); ++i) {
+        level[i] = min(prev[i], prev[i + (1 << (h-1))]);
+      }
+      this->sparse_table.push_back(level);
+    }
+  }
+
+  /**
+   * The longest common prefix of the suffixes with ranks l < r, the minimum
+   * of lcp[l...r-1], in O(1).
+   */
+  int range_lcp(int l, int r) {
+    int k = 31 - __builtin_clz(r - l);
+    return min(this->sparse_table[k][l], this->sparse_table[k][r - (1 << k)]);
+  }
+
+  /**
+   * Manber-Myers binary search for the first suffix that does not start with
+   * a string smaller than the pattern, or with upper, the first suffix that
+   * starts with a string larger than it. The LCP of the bounds with each
+   * other and with the pattern skips characters that are known to match, see
+   * labs/lab3/task3 for details.
+   *
+   * Time complexity: O(|P| + log(n))
+   */
+  int bound(const string &pattern, bool upper) {
+    int n = this->p.size();
+    int m = pattern.size();
+    int L = -1, R = n;
+    int l = 0, r = 0;
+    while (R - L > 1) {
+      int M = (L + R) / 2;
+      int k;
+      if (l >= r && L >= 0) {
+        int x = range_lcp(L, M);
+        if (x != l) {
+          if (x > l) {
+            L = M;
+          }
+          else {
+            R = M;
+            r = x;
+          }
+          continue;
+        }
+        k = l;
+      }
+      else if (r > l && R < n) {
+        int x = range_lcp(M, R);
+        if (x != r) {
+          if (x > r) {
+            R = M;
+          }
+          else {
+            L = M;
+            l = x;
+          }
+          continue;
+        }
+        k = r;
+      }
+      else {
+        k = min(l, r);
+      }
+
+      int i = this->p[M];
+      while (k < m && i + k < n && this->text[i + k] == pattern[k]) {
+        k++;
+      }
+      bool before;
+      if (k == m) {
+        before = upper;
+      }
+      else if (i + k == n) {
+        before = true;
+      }
+      else {
+        before = (unsigned char) this->text[i + k] < (unsigned char) pattern[k];
+      }
+      if (before) {
+        L = M;
+        l = k;
+      }
+      else {
+        R = M;
+        r = k;
+      }
+    }
+    return R;
   }
 
 public:
-  SuffixArray(string &s) {
-    construct_suffix_array(s);
-    construct_lcp_array(s);
+  /**
+   * The suffix array keeps the text, so pass it with move() to avoid holding
+   * it twice.
+   */
+  SuffixArray(string s) : text(move(s)) {
+    construct_suffix_array(this->text);
+    construct_lcp_array(this->text);
+  }
+
+  const string &get_text() {
+    return this->text;
   }
 
   int get_suffix(int i) {
     return this->p[i];
   }
 
-  vector<int> get_lcp() {
+  const vector<int> &get_lcp() {
     return this->lcp;
   }
+
+  /**
+   * The suffix array interval [begin, end) of the suffixes starting with the
+   * pattern, in O(|P| + log(n)).
+   */
+  pair<int, int> find_range(const string &pattern) {
+    return {bound(pattern, false), bound(pattern, true)};
+  }
+
+  /**
+   * The start positions of all occurrences of the pattern, in suffix array
+   * order, without scanning the text.
+   */
+  vector<int> occurrences(const string &pattern) {
+    pair<int, int> range = find_range(pattern);
+    return vector<int>(this->p.begin() + range.first, this->p.begin() + range.second);
+  }
 };